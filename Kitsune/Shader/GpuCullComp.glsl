@@ -0,0 +1,74 @@
+#version 460
+
+#extension GL_KHR_vulkan_glsl : enable
+#pragma shader_stage(compute)
+
+layout(local_size_x = 64) in;
+
+// KitGpuObject, the vertex shaders read the two matrices of the same records as instance data
+struct GpuObject {
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+	vec4 sphere;     // World space center and radius
+	uint indexCount; // 0 marks a free slot
+	uint firstIndex;
+	int vertexOffset;
+	uint batch;
+};
+
+// VkDrawIndexedIndirectCommand
+struct DrawCommand {
+	uint indexCount;
+	uint instanceCount;
+	uint firstIndex;
+	int vertexOffset;
+	uint firstInstance;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Objects {
+	GpuObject objects[];
+};
+
+// First command of each batch, a batch being every object drawn from one geometry arena page
+layout(std430, set = 0, binding = 1) readonly buffer Batches {
+	uint batchOffsets[];
+};
+
+layout(std430, set = 0, binding = 2) writeonly buffer Commands {
+	DrawCommand commands[];
+};
+
+// Cleared before the dispatch, the visible object count of each batch
+layout(std430, set = 0, binding = 3) buffer Counts {
+	uint counts[];
+};
+
+layout(push_constant) uniform Push {
+	vec4 planes[6]; // Point inwards, normalized
+	uint objectCount;
+} push;
+
+void main() {
+	uint objectIndex = gl_GlobalInvocationID.x;
+	if (objectIndex >= push.objectCount || objects[objectIndex].indexCount == 0) {
+		return;
+	}
+
+	vec4 sphere = objects[objectIndex].sphere;
+	for (int i = 0; i < 6; i++) {
+		if (dot(push.planes[i].xyz, sphere.xyz) + push.planes[i].w < -sphere.w) {
+			return;
+		}
+	}
+
+	// The first instance selects the object record at the instance rate vertex binding
+	uint batch = objects[objectIndex].batch;
+	uint slot = atomicAdd(counts[batch], 1);
+
+	commands[batchOffsets[batch] + slot] = DrawCommand(
+		objects[objectIndex].indexCount,
+		1,
+		objects[objectIndex].firstIndex,
+		objects[objectIndex].vertexOffset,
+		objectIndex);
+}
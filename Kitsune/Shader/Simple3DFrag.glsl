@@ -9,25 +9,42 @@ layout(location = 2) in vec3 fragNormalWorld;
 
 layout (location = 0) out vec4 outColor;
 
+// Must match KitGlobalGraphicsDefines.h
+const uint CLUSTER_COUNT_X = 16;
+const uint CLUSTER_COUNT_Y = 9;
+const uint CLUSTER_COUNT_Z = 24;
+
 struct PointLight {
-	vec4 position; // ignore w
+	vec4 position; // w is the range
 	vec4 color; // w is intensity
 };
 
+struct Cluster {
+	uint offset;
+	uint count;
+};
+
 layout(set = 0, binding = 0) uniform GlobalUBO {
 	mat4 projectionMatrix;
 	mat4 ViewMatrix;
 	mat4 invView;
 	vec3 directionToLight;
 	vec4 ambientColor;
-	PointLight pointLights[10];
+	vec4 clusterScale; // xy: fragment coordinate to tile, zw: log view depth to slice
 	int numLights;
 } ubo;
 
-layout(push_constant) uniform KitPushConstantsData {
-	mat4 modelMatrix;
-	mat4 normalMatrix;
-} kitPushConstantsData;
+layout(std430, set = 0, binding = 1) readonly buffer PointLights {
+	PointLight pointLights[];
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer Clusters {
+	Cluster clusters[];
+};
+
+layout(std430, set = 0, binding = 3) readonly buffer ClusterLightIndices {
+	uint lightIndices[];
+};
 
 void main() {
 	vec3 diffuseLight = ubo.ambientColor.xyz * ubo.ambientColor.w;
@@ -37,11 +54,22 @@ void main() {
 	vec3 cameraPosWorld = ubo.invView[3].xyz;
 	vec3 viewDirection = normalize(cameraPosWorld - fragPosWorld);
 
-	for (int i = 0; i < ubo.numLights; i++) {
-		PointLight light = ubo.pointLights[i];
+	// Only the lights listed for the cluster holding this fragment
+	float viewDepth = (ubo.ViewMatrix * vec4(fragPosWorld, 1.0)).z;
+	uint slice = uint(clamp(log(viewDepth) * ubo.clusterScale.z + ubo.clusterScale.w, 0.0, float(CLUSTER_COUNT_Z - 1)));
+	uvec2 tile = min(uvec2(gl_FragCoord.xy * ubo.clusterScale.xy), uvec2(CLUSTER_COUNT_X - 1, CLUSTER_COUNT_Y - 1));
+	Cluster cluster = clusters[tile.x + CLUSTER_COUNT_X * (tile.y + CLUSTER_COUNT_Y * slice)];
+
+	for (uint i = 0; i < cluster.count; i++) {
+		PointLight light = pointLights[lightIndices[cluster.offset + i]];
 
 		vec3 directionToLight = light.position.xyz - fragPosWorld;
-		float attenuation = 1.0 / dot(directionToLight, directionToLight); // distance squared cheez
+		float distanceSquared = dot(directionToLight, directionToLight);
+
+		// Inverse square falloff windowed to reach zero at the light range
+		float rangeRatio = distanceSquared / (light.position.w * light.position.w);
+		float window = clamp(1.0 - rangeRatio * rangeRatio, 0.0, 1.0);
+		float attenuation = window * window / distanceSquared;
 		directionToLight = normalize(directionToLight);
 
 		float cosAngIncidence = max(dot(surfaceNormal, directionToLight), 0);
@@ -0,0 +1,55 @@
+#version 460
+
+#extension GL_KHR_vulkan_glsl : enable
+#pragma shader_stage(vertex)
+
+// KitPackedVertex, the instance model matrix already contains the mesh's dequantize transform
+layout(location = 0) in vec3 position; // unorm16 within the mesh bounds
+layout(location = 1) in vec3 color;    // RGBA8 unorm
+layout(location = 2) in vec2 normal;   // Octahedral snorm16
+layout(location = 3) in vec2 uv;       // Half floats
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragPosWorld;
+layout(location = 2) out vec3 fragNormalWorld;
+
+struct PointLight {
+	vec4 position; // ignore w
+	vec4 color; // w is intensity
+};
+
+layout(set = 0, binding = 0) uniform GlobalUBO {
+	mat4 projectionMatrix;
+	mat4 ViewMatrix;
+	mat4 invView;
+	vec3 directionToLight;
+	vec4 ambientColor;
+	vec4 clusterScale; // xy: fragment coordinate to tile, zw: log view depth to slice
+	int numLights;
+} ubo;
+
+// KitInstanceData, stepped once per instance from the render system's instance buffer
+layout(location = 4) in mat4 instanceModelMatrix;
+layout(location = 8) in mat4 instanceNormalMatrix;
+
+vec3 OctahedralDecode(vec2 encoded) {
+	vec3 n = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+	float t = max(-n.z, 0.0);
+	n.x += n.x >= 0.0 ? -t : t;
+	n.y += n.y >= 0.0 ? -t : t;
+	return normalize(n);
+}
+
+void main() {
+	vec4 worldPosition = instanceModelMatrix * vec4(position, 1.0);
+
+	gl_Position = ubo.projectionMatrix * ubo.ViewMatrix * worldPosition;
+
+	// No need for 4x4 since normal is just a direction
+	// mat3 normalMatrix = transpose(inverse(mat3(instanceModelMatrix)));
+	// vec3 normalWorldSpace = normalize(normalMatrix * normal);
+
+	fragNormalWorld = normalize(mat3(instanceNormalMatrix) * OctahedralDecode(normal));
+	fragPosWorld = worldPosition.xyz;
+	fragColor = color;
+}
\ No newline at end of file
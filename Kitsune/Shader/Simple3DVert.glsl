@@ -23,25 +23,24 @@ layout(set = 0, binding = 0) uniform GlobalUBO {
 	mat4 invView;
 	vec3 directionToLight;
 	vec4 ambientColor;
-	PointLight pointLights[10];
+	vec4 clusterScale; // xy: fragment coordinate to tile, zw: log view depth to slice
 	int numLights;
 } ubo;
 
-layout(push_constant) uniform KitPushConstantsData {
-	mat4 modelMatrix;
-	mat4 normalMatrix;
-} kitPushConstantsData;
+// KitInstanceData, stepped once per instance from the render system's instance buffer
+layout(location = 4) in mat4 instanceModelMatrix;
+layout(location = 8) in mat4 instanceNormalMatrix;
 
 void main() {
-	vec4 worldPosition = kitPushConstantsData.modelMatrix * vec4(position, 1.0);
+	vec4 worldPosition = instanceModelMatrix * vec4(position, 1.0);
 
 	gl_Position = ubo.projectionMatrix * ubo.ViewMatrix * worldPosition;
 
 	// No need for 4x4 since normal is just a direction
-	// mat3 normalMatrix = transpose(inverse(mat3(kitPushConstantsData.model)));
+	// mat3 normalMatrix = transpose(inverse(mat3(instanceModelMatrix)));
 	// vec3 normalWorldSpace = normalize(normalMatrix * normal);
 
-	fragNormalWorld = normalize(mat3(kitPushConstantsData.normalMatrix) * normal);
+	fragNormalWorld = normalize(mat3(instanceNormalMatrix) * normal);
 	fragPosWorld = worldPosition.xyz;
 	fragColor = color;
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #pragma shader_stage(fragment)
 
 layout (location = 0) in vec2 fragOffset;
+layout (location = 1) flat in vec3 fragColor;
 layout (location = 0) out vec4 outColor;
 
 struct PointLight {
@@ -17,16 +18,10 @@ layout(set = 0, binding = 0) uniform GlobalUBO {
     mat4 invView;
     vec3 directionToLight;
     vec4 ambientColor;
-    PointLight pointLights[10];
+    vec4 clusterScale; // xy: fragment coordinate to tile, zw: log view depth to slice
     int numLights;
 } ubo;
 
-layout(push_constant) uniform Push {
-    vec4 position;
-    vec4 color;
-    float radius;
-} push;
-
 
 void main() {
     float dis = sqrt(dot(fragOffset, fragOffset));
@@ -34,5 +29,5 @@ void main() {
         discard;
     }
 
-    outColor = vec4(push.color.xyz, 1.0);
+    outColor = vec4(fragColor, 1.0);
 }
\ No newline at end of file
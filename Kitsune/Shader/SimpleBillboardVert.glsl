@@ -12,12 +12,12 @@ vec2(-1.0, 1.0),
 vec2(1.0, 1.0)
 );
 
-layout(location = 0) out vec2 fragOffset;
+// KitBillboardInstance, one per light
+layout(location = 0) in vec4 instancePosition; // w is the radius
+layout(location = 1) in vec4 instanceColor;    // w is intensity
 
-struct PointLight {
-    vec4 position; // ignore w
-    vec4 color; // w is intensity
-};
+layout(location = 0) out vec2 fragOffset;
+layout(location = 1) flat out vec3 fragColor;
 
 layout(set = 0, binding = 0) uniform GlobalUBO {
     mat4 projectionMatrix;
@@ -25,27 +25,22 @@ layout(set = 0, binding = 0) uniform GlobalUBO {
     mat4 invView;
     vec3 directionToLight;
     vec4 ambientColor;
-    PointLight pointLights[10];
+    vec4 clusterScale; // xy: fragment coordinate to tile, zw: log view depth to slice
     int numLights;
 } ubo;
 
-layout(push_constant) uniform Push {
-    vec4 position;
-    vec4 color;
-    float radius;
-} push;
-
-const float LIGHT_RADIUS = 0.1;
-
 void main() {
     fragOffset = OFFSETS[gl_VertexIndex];
 
     vec3 cameraRightWorld = {ubo.ViewMatrix[0][0], ubo.ViewMatrix[1][0], ubo.ViewMatrix[2][0]};
     vec3 cameraUpWorld = {ubo.ViewMatrix[0][1], ubo.ViewMatrix[1][1], ubo.ViewMatrix[2][1]};
 
-    vec3 positionWorld = push.position.xyz
-    + push.radius * fragOffset.x * cameraRightWorld
-    + push.radius * fragOffset.y * cameraUpWorld;
+    float radius = instancePosition.w;
+
+    vec3 positionWorld = instancePosition.xyz
+    + radius * fragOffset.x * cameraRightWorld
+    + radius * fragOffset.y * cameraUpWorld;
 
+    fragColor = instanceColor.xyz;
     gl_Position = ubo.projectionMatrix * ubo.ViewMatrix * vec4(positionWorld, 1.0);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 C:/VulkanSDK/1.3.296.0/Bin/glslc.exe Shader/Simple3DVert.glsl -o shader/Simple3DVert.spv
+C:/VulkanSDK/1.3.296.0/Bin/glslc.exe Shader/Simple3DPackedVert.glsl -o shader/Simple3DPackedVert.spv
 C:/VulkanSDK/1.3.296.0/Bin/glslc.exe Shader/Simple3DFrag.glsl -o shader/Simple3DFrag.spv
 C:/VulkanSDK/1.3.296.0/Bin/glslc.exe Shader/SimpleBillboardVert.glsl -o shader/SimpleBillboardVert.spv
 C:/VulkanSDK/1.3.296.0/Bin/glslc.exe Shader/SimpleBillboardFrag.glsl -o shader/SimpleBillboardFrag.spv
+C:/VulkanSDK/1.3.296.0/Bin/glslc.exe Shader/GpuCullComp.glsl -o shader/GpuCullComp.spv
 
 pause
\ No newline at end of file
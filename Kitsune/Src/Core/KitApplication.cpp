@@ -11,12 +11,15 @@
 #include <glm/glm.hpp>
 
 #include <chrono>
+#include <random>
 
 #include "Graphics/KitGlobalGraphicsDefines.h"
 #include "KitInputController.h"
 #include "Graphics/RenderSystems/KitGizmoBillboardRenderSystem.h"
+#include "Graphics/RenderSystems/KitGpuDrivenRenderSystem.h"
 #include "System/Subsystems/Caches/KitModelResourceCache.h"
 #include "System/Subsystems/KitResourceSystem.h"
+#include "System/Subsystems/KitResourceWatcherSystem.h"
 
 namespace Kitsune
 {
@@ -27,16 +30,21 @@ namespace Kitsune
 
         window_        = std::make_unique<KitWindow>(KitWindowInfo(default_width, default_height, default_title));
         engine_device_ = std::make_unique<KitEngineDevice>(window_.get());
-        renderer_      = std::make_unique<KitRenderer>(window_.get(), engine_device_.get());
+        job_system_    = std::make_unique<KitJobSystem>();
+        renderer_      = std::make_unique<KitRenderer>(window_.get(), engine_device_.get(), job_system_->GetParticipantCount());
 
         system_manager_.Init(engine_device_.get());
+        system_manager_.AddSystem<KitResourceWatcherSystem>();
         system_manager_.AddSystem<KitResourceSystem>();
 
         descriptor_pool_ = KitDescriptorPool::KitDescriptorPoolBuilder(engine_device_.get())
                            .SetMaxSets(KitSwapChain::MAX_FRAMES_IN_FLIGHT)
                            .AddPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, KitSwapChain::MAX_FRAMES_IN_FLIGHT)
+                           .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 3 * KitSwapChain::MAX_FRAMES_IN_FLIGHT)
                            .Build();
 
+        clustered_lighting_ = std::make_unique<KitClusteredLighting>(engine_device_.get());
+
         LoadGameObjects();
     }
 
@@ -63,18 +71,34 @@ namespace Kitsune
 
         auto global_set_layout = KitDescriptorSetLayout::KitDescriptorSetLayoutBuilder(engine_device_.get())
                                  .AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_ALL)
+                                 .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                                 .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
+                                 .AddBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT)
                                  .Build();
 
         std::vector<VkDescriptorSet> global_descriptor_sets(KitSwapChain::MAX_FRAMES_IN_FLIGHT);
         for (int i = 0; i < KitSwapChain::MAX_FRAMES_IN_FLIGHT; i++)
         {
-            auto buffer_info = ubo_buffers[i]->DescriptorInfo();
+            auto buffer_info      = ubo_buffers[i]->DescriptorInfo();
+            auto light_info       = clustered_lighting_->GetLightBufferInfo(i);
+            auto cluster_info     = clustered_lighting_->GetClusterBufferInfo(i);
+            auto light_index_info = clustered_lighting_->GetLightIndexBufferInfo(i);
             KitDescriptorWriter(*global_set_layout, *descriptor_pool_)
                 .WriteBuffer(0, &buffer_info)
+                .WriteBuffer(1, &light_info)
+                .WriteBuffer(2, &cluster_info)
+                .WriteBuffer(3, &light_index_info)
                 .Build(global_descriptor_sets[i]);
         }
         render_system_manager_ = std::make_unique<KitRenderSystemManager>(engine_device_.get());
-        render_system_manager_->RegisterRenderSystem<KitBasicRenderSystem>();
+        if (IsGpuDriven())
+        {
+            render_system_manager_->RegisterRenderSystem<KitGpuDrivenRenderSystem>();
+        }
+        else
+        {
+            render_system_manager_->RegisterRenderSystem<KitBasicRenderSystem>();
+        }
         render_system_manager_->RegisterRenderSystem<KitGizmoBillboardRenderSystem>();
 
         render_system_manager_->Init(renderer_->GetRenderPass(), global_set_layout->GetDescriptorSetLayout());
@@ -83,7 +107,7 @@ namespace Kitsune
         // camera.SetViewDirection(glm::vec3(0.f), glm::vec3(.5f, .5f, 1.f));
         camera.SetViewTarget(glm::vec3(-1.f, -2.f, -2.f), glm::vec3(0.f, 0.f, 2.5f));
 
-        auto               viewer_object = KitGameObject::CreateGameObject();
+        KitTransform       viewer_transform;
         KitInputController input_controller;
 
         auto start = std::chrono::high_resolution_clock::now();
@@ -98,8 +122,8 @@ namespace Kitsune
 
             system_manager_.Update(frame_time);
 
-            input_controller.MoveXZ(window_->window_, frame_time, viewer_object);
-            camera.SetViewYXZ(viewer_object.transform.translation, viewer_object.transform.rotation);
+            input_controller.MoveXZ(window_->window_, frame_time, viewer_transform);
+            camera.SetViewYXZ(viewer_transform.translation, viewer_transform.rotation);
 
             float aspect = renderer_->GetAspectRatio();
             // camera.SetOrthographicProjectionMatrix(-aspect, aspect, -1, 1, -1, 1);
@@ -109,7 +133,7 @@ namespace Kitsune
             {
                 int          frame_index = renderer_->GetCurrentFrameIndex();
                 KitFrameInfo frame_info{frame_index, frame_time, command_buffer, &camera, global_descriptor_sets[frame_index],
-                                        game_objects_};
+                                        scene_, frustum_culler_.GetVisibleMeshes()};
 
                 // Update
                 KitGlobalUBO global_ubo;
@@ -117,12 +141,19 @@ namespace Kitsune
                 global_ubo.view         = camera.GetViewMatrix();
                 global_ubo.inverse_view = camera.GetInverseViewMatrix();
                 render_system_manager_->Update(frame_info, global_ubo);
+                scene_.UpdateTransforms(job_system_.get());
+                if (!IsGpuDriven())
+                {
+                    frustum_culler_.Cull(scene_, camera.GetFrustum(), job_system_.get());
+                }
+                clustered_lighting_->Update(frame_index, camera, renderer_->GetExtent(), scene_, global_ubo);
+                render_system_manager_->Prepare(frame_info);
                 ubo_buffers[frame_index]->WriteToBuffer(&global_ubo);
                 ubo_buffers[frame_index]->Flush(); // Manual flush because we didn't use host coherent
 
                 // Render
-                renderer_->BeginSwapChainRenderPass(command_buffer);
-                render_system_manager_->Render(frame_info);
+                renderer_->BeginSwapChainRenderPass(command_buffer, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+                render_system_manager_->Record(frame_info, *renderer_->GetCommandRecorder(), job_system_.get());
                 renderer_->EndSwapChainRenderPass(command_buffer);
 
                 renderer_->EndFrame();
@@ -139,25 +170,24 @@ namespace Kitsune
     void KitApplication::LoadGameObjects()
     {
         KitResourceSystem* resource_system = system_manager_.GetSystem<KitResourceSystem>();
-        resource_system->RegisterCache<KitModelResourceCache>();
+        resource_system->RegisterCache<KitModelResourceCache>(job_system_.get());
         KitModelResourceCache* model_resource = resource_system->GetCache<KitModelResourceCache>();
+        model_resource->SetWatcher(system_manager_.GetSystem<KitResourceWatcherSystem>());
 
-        model_resource->LoadFromFile("quad", "Resources/quad.obj");
-        quad_model_ = model_resource->Get("quad");
-
-        model_resource->LoadFromFile("pot", "C:/Users/jaymi/OneDrive/Desktop/smooth_vase.obj");
-        vase_model_ = model_resource->Get("pot");
+        // Both files are parsed in parallel, we only block once for the uploads
+        model_resource->LoadFromFileAsync("quad", "Resources/quad.obj");
+        model_resource->LoadFromFileAsync("pot", "C:/Users/jaymi/OneDrive/Desktop/smooth_vase.obj");
+        model_resource->WaitForPendingLoads();
+        engine_device_->GetMemoryAllocator()->LogStats();
 
-        auto vase_go            = KitGameObject::CreateGameObject();
-        vase_go.model           = vase_model_;
-        vase_go.transform.scale = {2.5f, 2.5f, 2.5f};
+        quad_model_ = model_resource->Get("quad"_rid);
+        vase_model_ = model_resource->Get("pot"_rid);
 
-        auto quad_go            = KitGameObject::CreateGameObject();
-        quad_go.model           = quad_model_;
-        quad_go.transform.scale = {2.5f, 2.5f, 2.5f};
+        KitTransform model_transform;
+        model_transform.scale = {2.5f, 2.5f, 2.5f};
 
-        game_objects_.push_back(vase_go);
-        game_objects_.push_back(quad_go);
+        scene_.CreateModelEntity(vase_model_, model_transform);
+        scene_.CreateModelEntity(quad_model_, model_transform);
 
         std::vector<glm::vec3> lightColors{
             {1.f, .1f, .1f},
@@ -170,14 +200,27 @@ namespace Kitsune
 
         for (int i = 0; i < lightColors.size(); i++)
         {
-            auto point_light  = KitGameObject::CreatePointLight(0.2f);
-            point_light.color = lightColors[i];
+            auto point_light  = scene_.CreatePointLight(0.2f, 0.1f, lightColors[i]);
             auto rotate_light = glm::rotate(
                 glm::mat4(1.f),
                 (i * glm::two_pi<float>()) / lightColors.size(),
                 {0.f, -1.f, 0.f});
-            point_light.transform.translation = glm::vec3(rotate_light * glm::vec4(-1.f, -1.f, -1.f, 1.f));
-            game_objects_.push_back(point_light);
+            KitTransform light_transform = *point_light.get<KitTransform>();
+            light_transform.translation  = glm::vec3(rotate_light * glm::vec4(-1.f, -1.f, -1.f, 1.f));
+            scene_.SetTransform(point_light, light_transform);
+        }
+
+        std::mt19937                          random(1337);
+        std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+        for (uint32_t i = 0; i < stress_light_count; i++)
+        {
+            const glm::vec3 color{unit(random), unit(random), unit(random)};
+            auto            point_light = scene_.CreatePointLight(0.02f, 0.02f, color);
+
+            KitTransform light_transform = *point_light.get<KitTransform>();
+            light_transform.translation  = glm::vec3(unit(random) * 8.f - 4.f, unit(random) * -2.f, unit(random) * 8.f - 4.f);
+            scene_.SetTransform(point_light, light_transform);
         }
     }
 } // namespace Kitsune
@@ -2,11 +2,14 @@
 #include <memory>
 
 #include "Graphics/KitWindow.h"
-#include "Core/Scene/KitGameObject.h"
+#include "Core/Scene/KitScene.h"
+#include "Graphics/KitClusteredLighting.h"
 #include "Graphics/KitDescriptor.h"
+#include "Graphics/KitFrustumCuller.h"
 
 #include "Graphics/KitRenderer.h"
 #include "Graphics/RenderSystems/KitRenderSystemManager.h"
+#include "KitJobSystem.h"
 #include "System/KitSystemManager.h"
 
 namespace Kitsune
@@ -14,18 +17,27 @@ namespace Kitsune
     constexpr uint32_t default_width    = 800;
     constexpr uint32_t default_height   = 600;
     constexpr const char* default_title = "Kitsune Tools";
+
+    // Extra small lights scattered around the scene to stress the clustered lighting, up to MAX_LIGHTS in total
+    constexpr uint32_t stress_light_count = 0;
+
+    // Culls and builds the mesh draws on the GPU, needs multi draw indirect and falls back to the CPU path without it
+    constexpr bool use_gpu_driven_rendering = false;
     
     class KitApplication final
     {
         std::unique_ptr<KitWindow> window_;
         std::unique_ptr<KitEngineDevice> engine_device_;
         std::unique_ptr<KitRenderer> renderer_;
+        std::unique_ptr<KitJobSystem> job_system_;
 
         KitSystemManager system_manager_;
         std::unique_ptr<KitRenderSystemManager> render_system_manager_ = nullptr;
 
-        std::unique_ptr<KitDescriptorPool> descriptor_pool_;
-        std::vector<KitGameObject> game_objects_;
+        std::unique_ptr<KitDescriptorPool>    descriptor_pool_;
+        std::unique_ptr<KitClusteredLighting> clustered_lighting_;
+        KitScene         scene_;
+        KitFrustumCuller frustum_culler_;
 
         std::shared_ptr<KitModel> quad_model_ = nullptr;
         std::shared_ptr<KitModel> vase_model_ = nullptr;
@@ -47,5 +59,10 @@ namespace Kitsune
     private:
         void LoadModel();
         void LoadGameObjects();
+
+        KIT_NODISCARD bool IsGpuDriven() const
+        {
+            return use_gpu_driven_rendering && engine_device_->IsMultiDrawIndirectSupported();
+        }
     };
 }
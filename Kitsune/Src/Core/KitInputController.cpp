@@ -4,7 +4,7 @@
 
 namespace Kitsune
 {
-    void KitInputController::MoveXZ(GLFWwindow* window, const float dt, KitGameObject& game_object)
+    void KitInputController::MoveXZ(GLFWwindow* window, const float dt, KitTransform& transform)
     {
         glm::vec3 rotation(0.f);
         if(glfwGetKey(window, keys.look_right) == GLFW_PRESS)
@@ -29,13 +29,13 @@ namespace Kitsune
 
         if (glm::dot(rotation, rotation) > std::numeric_limits<float>::epsilon())
         {
-            game_object.transform.rotation += rotate_speed * dt *glm::normalize(rotation);
+            transform.rotation += rotate_speed * dt *glm::normalize(rotation);
         }
 
-        game_object.transform.rotation.x = glm::clamp(game_object.transform.rotation.x, -1.5f, 1.5f);
-        game_object.transform.rotation.y = glm::mod(game_object.transform.rotation.y, glm::two_pi<float>());
+        transform.rotation.x = glm::clamp(transform.rotation.x, -1.5f, 1.5f);
+        transform.rotation.y = glm::mod(transform.rotation.y, glm::two_pi<float>());
 
-        float yaw = game_object.transform.rotation.y;
+        float yaw = transform.rotation.y;
         glm::vec3 front(sin(yaw), 0.f, cos(yaw));
         glm::vec3 right(front.z, 0.f, -front.x);
         glm::vec3 up(0.f, -1.f, 0.f);
@@ -74,7 +74,7 @@ namespace Kitsune
 
         if (glm::dot(move_dir, move_dir) > std::numeric_limits<float>::epsilon())
         {
-            game_object.transform.translation += move_speed * dt *glm::normalize(move_dir);
+            transform.translation += move_speed * dt *glm::normalize(move_dir);
         }
     }
 }
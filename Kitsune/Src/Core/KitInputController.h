@@ -1,7 +1,7 @@
 ﻿#pragma once
 #include <GLFW/glfw3.h>
 
-#include "Scene/KitGameObject.h"
+#include "Scene/Components/KitTransformComponent.h"
 
 namespace Kitsune
 {
@@ -26,6 +26,6 @@ namespace Kitsune
         float move_speed = 3.f;
         float rotate_speed = 1.5f;
 
-        void MoveXZ(GLFWwindow* window, const float dt, KitGameObject& game_object);
+        void MoveXZ(GLFWwindow* window, const float dt, KitTransform& transform);
     };
 }
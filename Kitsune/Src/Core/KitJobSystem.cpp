@@ -0,0 +1,179 @@
+#include "KitJobSystem.h"
+
+#include <algorithm>
+
+#include "KitLogs.h"
+
+namespace Kitsune
+{
+    KitJobSystem::KitJobSystem(uint32_t worker_count)
+    {
+        if (worker_count == 0)
+        {
+            const uint32_t hardware_threads = std::thread::hardware_concurrency();
+            worker_count = std::max(1u, hardware_threads > 1 ? hardware_threads - 1 : 1u);
+        }
+
+        KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_INFO, "Starting job system with {} workers", worker_count);
+
+        workers_.reserve(worker_count);
+        for (uint32_t i = 0; i < worker_count; i++)
+        {
+            workers_.emplace_back(&KitJobSystem::WorkerLoop, this);
+        }
+    }
+
+    KitJobSystem::~KitJobSystem()
+    {
+        {
+            std::lock_guard lock(mutex_);
+            is_stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (std::thread& worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void KitJobSystem::ParallelFor(const uint32_t chunk_count, const std::function<void(uint32_t, uint32_t)>& func)
+    {
+        if (chunk_count == 0)
+        {
+            return;
+        }
+
+        const uint32_t participant_count = GetParticipantCount();
+
+        // Shared with the helper jobs, which may only start after everything is done and must find nothing left
+        auto state               = std::make_shared<KitParallelForState>();
+        state->func              = &func;
+        state->ranges            = std::make_unique<std::atomic<uint64_t>[]>(participant_count);
+        state->participant_count = participant_count;
+        state->chunk_count       = chunk_count;
+
+        for (uint32_t i = 0; i < participant_count; i++)
+        {
+            const uint64_t begin = static_cast<uint64_t>(chunk_count) * i / participant_count;
+            const uint64_t end   = static_cast<uint64_t>(chunk_count) * (i + 1) / participant_count;
+            state->ranges[i].store(begin | end << 32, std::memory_order_relaxed);
+        }
+
+        for (uint32_t i = 1; i < participant_count; i++)
+        {
+            Enqueue([state]() { RunParticipant(*state, state->next_participant.fetch_add(1)); });
+        }
+
+        RunParticipant(*state, 0);
+
+        // Nothing is left to take, wait for the chunks other participants are still running
+        uint32_t completed_count = state->completed_count.load();
+        while (completed_count != chunk_count)
+        {
+            state->completed_count.wait(completed_count);
+            completed_count = state->completed_count.load();
+        }
+    }
+
+    void KitJobSystem::RunParticipant(KitParallelForState& state, const uint32_t participant)
+    {
+        while (true)
+        {
+            uint32_t chunk = 0;
+            bool     found = PopChunk(state.ranges[participant], chunk);
+
+            for (uint32_t i = 1; !found && i < state.participant_count; i++)
+            {
+                found = StealChunk(state.ranges[(participant + i) % state.participant_count], chunk);
+            }
+
+            if (!found)
+            {
+                return;
+            }
+
+            (*state.func)(chunk, participant);
+
+            if (state.completed_count.fetch_add(1) + 1 == state.chunk_count)
+            {
+                state.completed_count.notify_all();
+            }
+        }
+    }
+
+    bool KitJobSystem::PopChunk(std::atomic<uint64_t>& range, uint32_t& chunk)
+    {
+        uint64_t value = range.load();
+        while (true)
+        {
+            const uint32_t begin = static_cast<uint32_t>(value);
+            const uint32_t end   = static_cast<uint32_t>(value >> 32);
+
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (range.compare_exchange_weak(value, (begin + 1) | static_cast<uint64_t>(end) << 32))
+            {
+                chunk = begin;
+                return true;
+            }
+        }
+    }
+
+    bool KitJobSystem::StealChunk(std::atomic<uint64_t>& range, uint32_t& chunk)
+    {
+        uint64_t value = range.load();
+        while (true)
+        {
+            const uint32_t begin = static_cast<uint32_t>(value);
+            const uint32_t end   = static_cast<uint32_t>(value >> 32);
+
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (range.compare_exchange_weak(value, begin | static_cast<uint64_t>(end - 1) << 32))
+            {
+                chunk = end - 1;
+                return true;
+            }
+        }
+    }
+
+    void KitJobSystem::Enqueue(std::function<void()> job)
+    {
+        {
+            std::lock_guard lock(mutex_);
+            jobs_.emplace_back(std::move(job));
+        }
+        condition_.notify_one();
+    }
+
+    void KitJobSystem::WorkerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+
+            {
+                std::unique_lock lock(mutex_);
+                condition_.wait(lock, [this]() { return is_stopping_ || !jobs_.empty(); });
+
+                // Pending jobs are dropped on shutdown, their futures report a broken promise
+                if (is_stopping_)
+                {
+                    return;
+                }
+
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+
+            job();
+        }
+    }
+} // Kitsune
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "KitDefinitions.h"
+
+namespace Kitsune
+{
+    class KitJobSystem final
+    {
+        std::vector<std::thread>          workers_;
+        std::deque<std::function<void()>> jobs_;
+
+        std::mutex              mutex_;
+        std::condition_variable condition_;
+        bool                    is_stopping_ = false;
+
+    public:
+        // Defaults to one worker per hardware thread, leaving the main thread free
+        explicit KitJobSystem(uint32_t worker_count = 0);
+        ~KitJobSystem();
+
+        KitJobSystem(const KitJobSystem&) = delete;
+        KitJobSystem(KitJobSystem&&)      = delete;
+
+        KitJobSystem& operator=(const KitJobSystem&) = delete;
+        KitJobSystem& operator=(KitJobSystem&&)      = delete;
+
+        KIT_NODISCARD uint32_t GetWorkerCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+        // Workers plus the thread calling ParallelFor
+        KIT_NODISCARD uint32_t GetParticipantCount() const { return GetWorkerCount() + 1; }
+
+        template <typename F>
+        auto Submit(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+        {
+            using ResultType = std::invoke_result_t<std::decay_t<F>>;
+
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(func));
+            std::future<ResultType> future = task->get_future();
+
+            Enqueue([task]() { (*task)(); });
+
+            return future;
+        }
+
+        // Calls func(chunk, participant) for every chunk in [0, chunk_count) and returns once all of them ran.
+        // Each participant starts on its own contiguous block of chunks and steals from the others once it runs dry,
+        // so chunks of uneven cost and workers busy with other jobs still finish together. The calling thread takes part
+        // as participant 0, participants are below GetParticipantCount() and never run two chunks at the same time.
+        void ParallelFor(uint32_t chunk_count, const std::function<void(uint32_t, uint32_t)>& func);
+
+    private:
+        // Chunks left to a participant, begin in the low and end in the high half. The owner takes from the front and
+        // thieves from the back, both with a compare exchange on the whole range.
+        struct KitParallelForState
+        {
+            const std::function<void(uint32_t, uint32_t)>* func = nullptr;
+
+            std::unique_ptr<std::atomic<uint64_t>[]> ranges;
+            uint32_t                                 participant_count = 0;
+            uint32_t                                 chunk_count       = 0;
+
+            std::atomic<uint32_t> next_participant{1};
+            std::atomic<uint32_t> completed_count{0};
+        };
+
+        static void RunParticipant(KitParallelForState& state, uint32_t participant);
+        static bool PopChunk(std::atomic<uint64_t>& range, uint32_t& chunk);
+        static bool StealChunk(std::atomic<uint64_t>& range, uint32_t& chunk);
+
+        void Enqueue(std::function<void()> job);
+        void WorkerLoop();
+    };
+} // Kitsune
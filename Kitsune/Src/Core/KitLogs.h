@@ -32,6 +32,7 @@ namespace Kitsune
 
         inline static std::shared_ptr<spdlog::logger> low_level_graphic_logger_;
         inline static std::shared_ptr<spdlog::logger> engine_logger_;
+        inline static std::shared_ptr<spdlog::logger> io_logger_;
         
     public:
         static void InitLoggers();
@@ -121,6 +122,9 @@ assert(condition) \
         low_level_graphic_logger_ = std::make_shared<spdlog::logger>(LOG_LOW_LEVEL_GRAPHIC, logger_sinks_.begin(), logger_sinks_.end());
         spdlog::register_logger(low_level_graphic_logger_);
 
+        io_logger_ = std::make_shared<spdlog::logger>(LOG_IO, logger_sinks_.begin(), logger_sinks_.end());
+        spdlog::register_logger(io_logger_);
+
         KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_INFO, "Logger initialized...");
     }
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#include "KitMappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Kitsune
+{
+    KitMappedFile::~KitMappedFile()
+    {
+#ifdef _WIN32
+        if (data_ != nullptr)
+        {
+            UnmapViewOfFile(data_);
+        }
+
+        if (mapping_handle_ != nullptr)
+        {
+            CloseHandle(mapping_handle_);
+        }
+
+        if (file_handle_ != nullptr)
+        {
+            CloseHandle(file_handle_);
+        }
+#else
+        if (data_ != nullptr)
+        {
+            munmap(const_cast<uint8_t*>(data_), size_);
+        }
+
+        if (file_descriptor_ >= 0)
+        {
+            close(file_descriptor_);
+        }
+#endif
+    }
+
+    std::unique_ptr<KitMappedFile> KitMappedFile::Open(const std::string& file_path)
+    {
+        std::unique_ptr<KitMappedFile> mapped_file(new KitMappedFile());
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(
+            file_path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+        mapped_file->file_handle_ = file;
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+        {
+            return nullptr;
+        }
+        mapped_file->size_ = static_cast<size_t>(file_size.QuadPart);
+
+        mapped_file->mapping_handle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapped_file->mapping_handle_ == nullptr)
+        {
+            return nullptr;
+        }
+
+        mapped_file->data_ = static_cast<const uint8_t*>(MapViewOfFile(mapped_file->mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+        if (mapped_file->data_ == nullptr)
+        {
+            return nullptr;
+        }
+#else
+        mapped_file->file_descriptor_ = open(file_path.c_str(), O_RDONLY);
+        if (mapped_file->file_descriptor_ < 0)
+        {
+            return nullptr;
+        }
+
+        struct stat file_stat{};
+        if (fstat(mapped_file->file_descriptor_, &file_stat) != 0 || file_stat.st_size == 0)
+        {
+            return nullptr;
+        }
+        mapped_file->size_ = static_cast<size_t>(file_stat.st_size);
+
+        void* data = mmap(nullptr, mapped_file->size_, PROT_READ, MAP_PRIVATE, mapped_file->file_descriptor_, 0);
+        if (data == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        mapped_file->data_ = static_cast<const uint8_t*>(data);
+
+        // The whole file is consumed front to back by the upload
+        madvise(data, mapped_file->size_, MADV_SEQUENTIAL);
+#endif
+
+        return mapped_file;
+    }
+} // Kitsune
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "KitDefinitions.h"
+
+namespace Kitsune
+{
+    // Read-only view of a whole file, backed by the OS page cache
+    class KitMappedFile final
+    {
+        const uint8_t* data_ = nullptr;
+        size_t         size_ = 0;
+
+#ifdef _WIN32
+        void* file_handle_    = nullptr;
+        void* mapping_handle_ = nullptr;
+#else
+        int file_descriptor_ = -1;
+#endif
+
+        KitMappedFile() = default;
+
+    public:
+        ~KitMappedFile();
+
+        KitMappedFile(const KitMappedFile&)            = delete;
+        KitMappedFile& operator=(const KitMappedFile&) = delete;
+
+        // Returns nullptr if the file does not exist, is empty or could not be mapped
+        static std::unique_ptr<KitMappedFile> Open(const std::string& file_path);
+
+        KIT_NODISCARD const uint8_t* GetData() const { return data_; }
+        KIT_NODISCARD size_t GetSize() const { return size_; }
+    };
+} // Kitsune
@@ -0,0 +1,54 @@
+#include "KitResourceId.h"
+
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "KitLogs.h"
+
+namespace Kitsune
+{
+    namespace
+    {
+        struct KitResourceNameTable
+        {
+            std::shared_mutex                              mutex;
+            std::unordered_map<KitResourceId, std::string> names;
+        };
+
+        KitResourceNameTable& GetNameTable()
+        {
+            static KitResourceNameTable name_table;
+            return name_table;
+        }
+    }
+
+    KitResourceId KitResourceId::Intern(const std::string_view name)
+    {
+        const KitResourceId id(name);
+        KitResourceNameTable& name_table = GetNameTable();
+
+        std::unique_lock lock(name_table.mutex);
+
+        const auto [it, is_inserted] = name_table.names.try_emplace(id, name);
+        KIT_ASSERT(LOG_ENGINE, is_inserted || it->second == name, "Resource id collision between {} and {}", it->second, name);
+
+        return id;
+    }
+
+    std::string KitResourceId::GetName() const
+    {
+        KitResourceNameTable& name_table = GetNameTable();
+
+        {
+            std::shared_lock lock(name_table.mutex);
+
+            if (const auto it = name_table.names.find(*this); it != name_table.names.end())
+            {
+                return it->second;
+            }
+        }
+
+        return fmt::format("{:016x}", value_);
+    }
+} // namespace Kitsune
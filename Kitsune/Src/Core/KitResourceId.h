@@ -0,0 +1,72 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "KitDefinitions.h"
+#include "KitUtil.h"
+
+namespace Kitsune
+{
+    // Stable 64-bit name of a resource, the FNV-1a hash of its name.
+    // Literal names hash at compile time with the _rid suffix, looking it up afterwards only costs an integer compare.
+    class KitResourceId
+    {
+        uint64_t value_ = 0;
+
+    public:
+        constexpr KitResourceId() = default;
+
+        constexpr explicit KitResourceId(const uint64_t value) :
+            value_(value)
+        {
+        }
+
+        constexpr KitResourceId(const std::string_view name) :
+            value_(KitUtil::HashString(name))
+        {
+        }
+
+        constexpr KitResourceId(const char* name) :
+            KitResourceId(std::string_view(name))
+        {
+        }
+
+        KitResourceId(const std::string& name) :
+            KitResourceId(std::string_view(name))
+        {
+        }
+
+        // Hashes the name and remembers it so GetName() and collision checks work, use for names known at runtime
+        static KitResourceId Intern(std::string_view name);
+
+        // The interned name, or the hex value when the id was never interned
+        KIT_NODISCARD std::string GetName() const;
+
+        KIT_NODISCARD constexpr uint64_t GetValue() const { return value_; }
+        KIT_NODISCARD constexpr bool IsValid() const { return value_ != 0; }
+
+        constexpr auto operator<=>(const KitResourceId&) const = default;
+    };
+
+    inline namespace literals
+    {
+        consteval KitResourceId operator""_rid(const char* name, const size_t length)
+        {
+            return KitResourceId(std::string_view(name, length));
+        }
+    }
+} // namespace Kitsune
+
+template<>
+struct std::hash<Kitsune::KitResourceId>
+{
+    // Already a hash, no need to mix it again
+    size_t operator()(const Kitsune::KitResourceId& id) const noexcept
+    {
+        return static_cast<size_t>(id.GetValue());
+    }
+};
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "KitLogs.h"
@@ -11,6 +13,38 @@ namespace Kitsune
     class KitUtil
     {
     public:
+        static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+        static constexpr uint64_t FNV_PRIME        = 1099511628211ull;
+
+        // 64-bit FNV-1a, pass the previous result as seed to hash several blocks
+        static uint64_t HashBytes(const void* data, const size_t size, const uint64_t seed = FNV_OFFSET_BASIS)
+        {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            uint64_t    hash  = seed;
+
+            for (size_t i = 0; i < size; i++)
+            {
+                hash ^= bytes[i];
+                hash *= FNV_PRIME;
+            }
+
+            return hash;
+        }
+
+        // Same hash as HashBytes over the characters, usable at compile time
+        static constexpr uint64_t HashString(const std::string_view string, const uint64_t seed = FNV_OFFSET_BASIS)
+        {
+            uint64_t hash = seed;
+
+            for (const char character : string)
+            {
+                hash ^= static_cast<uint8_t>(character);
+                hash *= FNV_PRIME;
+            }
+
+            return hash;
+        }
+
         static std::vector<char> ReadFile(const std::string& file_path)
         {
             std::ifstream file(file_path, std::ios::ate | std::ios::binary);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glm/vec3.hpp>
+
+namespace Kitsune
+{
+    class KitModel;
+
+    // Index into the model table of the scene
+    using KitModelHandle = uint32_t;
+
+    constexpr KitModelHandle INVALID_MODEL_HANDLE = UINT32_MAX;
+
+    struct KitModelComponent
+    {
+        KitModelHandle model = INVALID_MODEL_HANDLE;
+    };
+
+    struct KitColorComponent
+    {
+        glm::vec3 color{1.f, 1.f, 1.f};
+    };
+
+    // Leaf of the entity in the scene BVH, created once its world transform is first known
+    struct KitBvhProxyComponent
+    {
+        int32_t proxy = -1;
+    };
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Kitsune
+{
+    struct KitTransform
+    {
+        glm::vec3 translation{0.f, 0.f, 0.f};
+        glm::vec3 scale{1.f, 1.f, 1.f};
+        glm::vec3 rotation{0.f, 0.f, 0.f};
+
+        glm::mat4 ToMatrix() const
+        {
+            auto transform = glm::translate(glm::mat4(1.0f), translation);
+
+            transform = glm::rotate(transform, rotation.y, {0.f, 1.f, 0.f});
+            transform = glm::rotate(transform, rotation.x, {1.f, 0.f, 0.f});
+            transform = glm::rotate(transform, rotation.z, {0.f, 0.f, 1.f});
+
+            transform = glm::scale(transform, scale);
+
+            return transform;
+        }
+
+        glm::mat3 GetNormalMatrix() const
+        {
+            const glm::mat3x3 model_matrix3(ToMatrix());
+            return glm::inverseTranspose(model_matrix3);
+        }
+    };
+
+    // Matrices of a KitTransform, only rebuilt by KitScene::UpdateTransforms() after the transform was marked dirty
+    struct KitWorldTransform
+    {
+        glm::mat4 model_matrix{1.f};
+        glm::mat4 normal_matrix{1.f};
+
+        // Set while queued in the scene dirty list so an entity is queued once per frame
+        bool is_dirty = false;
+    };
+}
@@ -0,0 +1,591 @@
+#include "KitBvh.h"
+
+#include <algorithm>
+
+namespace Kitsune
+{
+    KitBvh::KitBvh(const float margin)
+        : margin_(margin)
+    {
+    }
+
+    int32_t KitBvh::CreateProxy(const KitAabb& aabb, const uint64_t user_data)
+    {
+        const int32_t proxy = AllocateNode();
+        KitBvhNode&   node  = nodes_[proxy];
+
+        node.aabb      = {aabb.min - margin_, aabb.max + margin_};
+        node.user_data = user_data;
+        node.height    = 0;
+
+        InsertLeaf(proxy);
+        proxy_count_++;
+
+        return proxy;
+    }
+
+    void KitBvh::DestroyProxy(const int32_t proxy)
+    {
+        KIT_ASSERT(LOG_ENGINE, proxy >= 0 && proxy < static_cast<int32_t>(nodes_.size()) && nodes_[proxy].height == 0,
+                   "Invalid BVH proxy {}", proxy);
+
+        RemoveLeaf(proxy);
+        FreeNode(proxy);
+        proxy_count_--;
+    }
+
+    bool KitBvh::MoveProxy(const int32_t proxy, const KitAabb& aabb)
+    {
+        KIT_ASSERT(LOG_ENGINE, proxy >= 0 && proxy < static_cast<int32_t>(nodes_.size()) && nodes_[proxy].height == 0,
+                   "Invalid BVH proxy {}", proxy);
+
+        if (nodes_[proxy].aabb.Contains(aabb))
+        {
+            return false;
+        }
+
+        RemoveLeaf(proxy);
+        nodes_[proxy].aabb = {aabb.min - margin_, aabb.max + margin_};
+        InsertLeaf(proxy);
+
+        return true;
+    }
+
+    void KitBvh::Rebuild()
+    {
+        KitBvhBuild build = CaptureBuild();
+        Build(build);
+        ApplyBuild(build);
+    }
+
+    KitBvh::KitBvhBuild KitBvh::CaptureBuild() const
+    {
+        KitBvhBuild build;
+        build.leaves.reserve(proxy_count_);
+        build.aabbs.reserve(proxy_count_);
+
+        for (int32_t i = 0; i < static_cast<int32_t>(nodes_.size()); i++)
+        {
+            if (nodes_[i].height == 0)
+            {
+                build.leaves.push_back(i);
+                build.aabbs.push_back(nodes_[i].aabb);
+            }
+        }
+
+        return build;
+    }
+
+    void KitBvh::Build(KitBvhBuild& build)
+    {
+        build.nodes.clear();
+
+        const int32_t count = static_cast<int32_t>(build.leaves.size());
+        if (count == 0)
+        {
+            return;
+        }
+
+        std::vector<glm::vec3> centers(count);
+        std::vector<int32_t>   order(count);
+
+        for (int32_t i = 0; i < count; i++)
+        {
+            centers[i] = build.aabbs[i].GetCenter();
+            order[i]   = i;
+        }
+
+        build.nodes.reserve(count - 1);
+        BuildTopDown(build, order.data(), count, centers);
+    }
+
+    void KitBvh::ApplyBuild(const KitBvhBuild& build)
+    {
+        // Leaves keep their index and with it their proxy id. The internal nodes are replaced in index order rather than
+        // through the free list, which would scatter the writes across the array.
+        std::vector<int32_t> internal_nodes;
+        internal_nodes.reserve(proxy_count_);
+
+        for (int32_t i = 0; i < static_cast<int32_t>(nodes_.size()); i++)
+        {
+            KitBvhNode& node = nodes_[i];
+            if (node.height < 0)
+            {
+                continue;
+            }
+
+            if (node.IsLeaf())
+            {
+                node.parent = NULL_NODE;
+            }
+            else
+            {
+                node.height = -1;
+                internal_nodes.push_back(i);
+            }
+        }
+
+        root_ = NULL_NODE;
+
+        size_t used_internal_count = 0;
+
+        std::vector<bool> is_placed(nodes_.size(), false);
+
+        // A captured leaf destroyed since is free by now, its parent collapses onto the other child
+        const auto resolve_leaf = [this, &build, &is_placed](const int32_t child)
+        {
+            const int32_t leaf = build.leaves[~child];
+            if (leaf >= static_cast<int32_t>(nodes_.size()) || nodes_[leaf].height != 0)
+            {
+                return NULL_NODE;
+            }
+
+            is_placed[leaf] = true;
+            return leaf;
+        };
+
+        std::vector<int32_t> resolved(build.nodes.size(), NULL_NODE);
+        for (size_t i = 0; i < build.nodes.size(); i++)
+        {
+            const KitBvhBuild::KitBuildNode& build_node = build.nodes[i];
+
+            const int32_t child1 = build_node.child1 < 0 ? resolve_leaf(build_node.child1) : resolved[build_node.child1];
+            const int32_t child2 = build_node.child2 < 0 ? resolve_leaf(build_node.child2) : resolved[build_node.child2];
+
+            if (child1 == NULL_NODE || child2 == NULL_NODE)
+            {
+                resolved[i] = child1 == NULL_NODE ? child2 : child1;
+                continue;
+            }
+
+            const int32_t index = used_internal_count < internal_nodes.size() ? internal_nodes[used_internal_count++] : AllocateNode();
+            KitBvhNode&   node  = nodes_[index];
+
+            // Boxes are taken from the leaves as they are now, not as they were captured
+            node.aabb      = KitAabb::Union(nodes_[child1].aabb, nodes_[child2].aabb);
+            node.user_data = 0;
+            node.parent    = NULL_NODE;
+            node.child1    = child1;
+            node.child2    = child2;
+            node.height = 1 + std::max(nodes_[child1].height, nodes_[child2].height);
+
+            nodes_[child1].parent = index;
+            nodes_[child2].parent = index;
+
+            resolved[i] = index;
+        }
+
+        if (!build.nodes.empty())
+        {
+            root_ = resolved.back();
+        }
+        else if (!build.leaves.empty())
+        {
+            root_ = resolve_leaf(~0);
+        }
+
+        if (root_ != NULL_NODE)
+        {
+            nodes_[root_].parent = NULL_NODE;
+        }
+
+        for (size_t i = used_internal_count; i < internal_nodes.size(); i++)
+        {
+            FreeNode(internal_nodes[i]);
+        }
+
+        // Created after the capture
+        for (int32_t i = 0; i < static_cast<int32_t>(is_placed.size()); i++)
+        {
+            if (nodes_[i].height == 0 && !is_placed[i])
+            {
+                InsertLeaf(i);
+            }
+        }
+    }
+
+    void KitBvh::SplitQuery(const KitFrustum& frustum, const uint32_t count, std::vector<KitBvhSubtree>& subtrees) const
+    {
+        subtrees.clear();
+        if (root_ == NULL_NODE)
+        {
+            return;
+        }
+
+        subtrees.push_back({root_, false});
+
+        // Each pass replaces every internal node with its children in place, which keeps the traversal order
+        std::vector<KitBvhSubtree> next_subtrees;
+        bool                       is_split = true;
+
+        while (is_split && subtrees.size() < count)
+        {
+            is_split = false;
+            next_subtrees.clear();
+
+            for (const KitBvhSubtree& subtree : subtrees)
+            {
+                const KitBvhNode& node = nodes_[subtree.node];
+                if (node.IsLeaf())
+                {
+                    next_subtrees.push_back(subtree);
+                    continue;
+                }
+
+                is_split = true;
+
+                bool is_inside = subtree.is_inside;
+                if (!is_inside)
+                {
+                    const KitFrustumTest test = frustum.Classify(node.aabb);
+                    if (test == KitFrustumTest::OUTSIDE)
+                    {
+                        continue;
+                    }
+
+                    is_inside = test == KitFrustumTest::INSIDE;
+                }
+
+                next_subtrees.push_back({node.child1, is_inside});
+                next_subtrees.push_back({node.child2, is_inside});
+            }
+
+            std::swap(subtrees, next_subtrees);
+        }
+    }
+
+    float KitBvh::GetAreaRatio() const
+    {
+        if (root_ == NULL_NODE)
+        {
+            return 0.f;
+        }
+
+        float total_area = 0.f;
+        for (const KitBvhNode& node : nodes_)
+        {
+            if (node.height > 0)
+            {
+                total_area += node.aabb.GetSurfaceArea();
+            }
+        }
+
+        const float root_area = nodes_[root_].aabb.GetSurfaceArea();
+        return root_area > 0.f ? total_area / root_area : 0.f;
+    }
+
+    bool KitBvh::Validate() const
+    {
+        if (root_ == NULL_NODE)
+        {
+            return proxy_count_ == 0;
+        }
+
+        if (nodes_[root_].parent != NULL_NODE)
+        {
+            return false;
+        }
+
+        uint32_t             leaf_count = 0;
+        std::vector<int32_t> stack      = {root_};
+        while (!stack.empty())
+        {
+            const int32_t     index = stack.back();
+            const KitBvhNode& node  = nodes_[index];
+            stack.pop_back();
+
+            if (node.IsLeaf())
+            {
+                if (node.height != 0)
+                {
+                    return false;
+                }
+
+                leaf_count++;
+                continue;
+            }
+
+            const KitBvhNode& child1 = nodes_[node.child1];
+            const KitBvhNode& child2 = nodes_[node.child2];
+            if (child1.parent != index || child2.parent != index ||
+                node.height != 1 + std::max(child1.height, child2.height) ||
+                !node.aabb.Contains(child1.aabb) || !node.aabb.Contains(child2.aabb))
+            {
+                return false;
+            }
+
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+
+        return leaf_count == proxy_count_;
+    }
+
+    int32_t KitBvh::AllocateNode()
+    {
+        if (free_list_ == NULL_NODE)
+        {
+            nodes_.emplace_back();
+            return static_cast<int32_t>(nodes_.size()) - 1;
+        }
+
+        const int32_t index = free_list_;
+        free_list_          = nodes_[index].parent;
+        nodes_[index]       = {};
+
+        return index;
+    }
+
+    void KitBvh::FreeNode(const int32_t index)
+    {
+        nodes_[index]        = {};
+        nodes_[index].parent = free_list_;
+        free_list_           = index;
+    }
+
+    void KitBvh::InsertLeaf(const int32_t leaf)
+    {
+        if (root_ == NULL_NODE)
+        {
+            root_               = leaf;
+            nodes_[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // Descend towards the sibling with the lowest cost, the cost of a node being the area it adds to the tree.
+        // Going down a level always pays for growing the current node, stop once that alone beats both children.
+        const KitAabb leaf_aabb = nodes_[leaf].aabb;
+        int32_t       index     = root_;
+
+        while (!nodes_[index].IsLeaf())
+        {
+            const KitBvhNode& node = nodes_[index];
+
+            const float area          = node.aabb.GetSurfaceArea();
+            const float combined_area = KitAabb::Union(node.aabb, leaf_aabb).GetSurfaceArea();
+
+            // Pairing with this node creates a parent with the combined box
+            const float cost             = 2.f * combined_area;
+            const float inheritance_cost = 2.f * (combined_area - area);
+
+            const auto child_cost = [this, &leaf_aabb, inheritance_cost](const int32_t child)
+            {
+                const KitAabb& child_aabb = nodes_[child].aabb;
+                const float    area       = KitAabb::Union(child_aabb, leaf_aabb).GetSurfaceArea();
+
+                return nodes_[child].IsLeaf() ? area + inheritance_cost
+                                              : area - child_aabb.GetSurfaceArea() + inheritance_cost;
+            };
+
+            const float cost1 = child_cost(node.child1);
+            const float cost2 = child_cost(node.child2);
+
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        const int32_t sibling    = index;
+        const int32_t old_parent = nodes_[sibling].parent;
+        const int32_t new_parent = AllocateNode();
+
+        KitBvhNode& parent_node = nodes_[new_parent];
+        parent_node.parent      = old_parent;
+        parent_node.aabb        = KitAabb::Union(leaf_aabb, nodes_[sibling].aabb);
+        parent_node.height      = nodes_[sibling].height + 1;
+        parent_node.child1      = sibling;
+        parent_node.child2      = leaf;
+
+        if (old_parent == NULL_NODE)
+        {
+            root_ = new_parent;
+        }
+        else if (nodes_[old_parent].child1 == sibling)
+        {
+            nodes_[old_parent].child1 = new_parent;
+        }
+        else
+        {
+            nodes_[old_parent].child2 = new_parent;
+        }
+
+        nodes_[sibling].parent = new_parent;
+        nodes_[leaf].parent    = new_parent;
+
+        Refit(new_parent);
+    }
+
+    void KitBvh::RemoveLeaf(const int32_t leaf)
+    {
+        if (leaf == root_)
+        {
+            root_ = NULL_NODE;
+            return;
+        }
+
+        const int32_t parent       = nodes_[leaf].parent;
+        const int32_t grand_parent = nodes_[parent].parent;
+        const int32_t sibling      = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+        FreeNode(parent);
+        nodes_[leaf].parent = NULL_NODE;
+
+        if (grand_parent == NULL_NODE)
+        {
+            root_                  = sibling;
+            nodes_[sibling].parent = NULL_NODE;
+            return;
+        }
+
+        if (nodes_[grand_parent].child1 == parent)
+        {
+            nodes_[grand_parent].child1 = sibling;
+        }
+        else
+        {
+            nodes_[grand_parent].child2 = sibling;
+        }
+
+        nodes_[sibling].parent = grand_parent;
+
+        Refit(grand_parent);
+    }
+
+    void KitBvh::Refit(int32_t index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = Balance(index);
+
+            KitBvhNode&       node   = nodes_[index];
+            const KitBvhNode& child1 = nodes_[node.child1];
+            const KitBvhNode& child2 = nodes_[node.child2];
+
+            node.height = 1 + std::max(child1.height, child2.height);
+            node.aabb   = KitAabb::Union(child1.aabb, child2.aabb);
+
+            index = node.parent;
+        }
+    }
+
+    int32_t KitBvh::Balance(const int32_t index)
+    {
+        KitBvhNode& a = nodes_[index];
+        if (a.IsLeaf() || a.height < 2)
+        {
+            return index;
+        }
+
+        const int32_t b_index = a.child1;
+        const int32_t c_index = a.child2;
+        KitBvhNode&   b       = nodes_[b_index];
+        KitBvhNode&   c       = nodes_[c_index];
+
+        const int32_t balance = c.height - b.height;
+
+        // Swaps a with its taller child, which keeps its own taller child and hands the shorter one down to a
+        const auto rotate_up = [this, index, &a](
+            const int32_t up_index,
+            KitBvhNode&   up,
+            KitBvhNode&   other,
+            const bool    is_right)
+        {
+            const int32_t f_index = up.child1;
+            const int32_t g_index = up.child2;
+            KitBvhNode&   f       = nodes_[f_index];
+            KitBvhNode&   g       = nodes_[g_index];
+
+            up.child1 = index;
+            up.parent = a.parent;
+            a.parent  = up_index;
+
+            if (up.parent == NULL_NODE)
+            {
+                root_ = up_index;
+            }
+            else if (nodes_[up.parent].child1 == index)
+            {
+                nodes_[up.parent].child1 = up_index;
+            }
+            else
+            {
+                nodes_[up.parent].child2 = up_index;
+            }
+
+            const bool    is_f_taller  = f.height > g.height;
+            const int32_t kept_index   = is_f_taller ? f_index : g_index;
+            const int32_t handed_index = is_f_taller ? g_index : f_index;
+            KitBvhNode&   kept         = nodes_[kept_index];
+            KitBvhNode&   handed       = nodes_[handed_index];
+
+            up.child2     = kept_index;
+            handed.parent = index;
+
+            if (is_right)
+            {
+                a.child2 = handed_index;
+            }
+            else
+            {
+                a.child1 = handed_index;
+            }
+
+            a.aabb    = KitAabb::Union(other.aabb, handed.aabb);
+            up.aabb   = KitAabb::Union(a.aabb, kept.aabb);
+            a.height  = 1 + std::max(other.height, handed.height);
+            up.height = 1 + std::max(a.height, kept.height);
+        };
+
+        if (balance > 1)
+        {
+            rotate_up(c_index, c, b, true);
+            return c_index;
+        }
+
+        if (balance < -1)
+        {
+            rotate_up(b_index, b, c, false);
+            return b_index;
+        }
+
+        return index;
+    }
+
+    int32_t KitBvh::BuildTopDown(
+        KitBvhBuild&                  build,
+        int32_t*                      order,
+        const int32_t                 count,
+        const std::vector<glm::vec3>& centers)
+    {
+        if (count == 1)
+        {
+            return ~order[0];
+        }
+
+        KitAabb center_bounds;
+        for (int32_t i = 0; i < count; i++)
+        {
+            center_bounds.Expand(centers[order[i]]);
+        }
+
+        const glm::vec3 size = center_bounds.max - center_bounds.min;
+        const int       axis = size.x > size.y ? (size.x > size.z ? 0 : 2) : (size.y > size.z ? 1 : 2);
+
+        const int32_t half = count / 2;
+        std::nth_element(order, order + half, order + count,
+                         [&centers, axis](const int32_t left, const int32_t right)
+                         {
+                             return centers[left][axis] < centers[right][axis];
+                         });
+
+        const int32_t child1 = BuildTopDown(build, order, half, centers);
+        const int32_t child2 = BuildTopDown(build, order + half, count - half, centers);
+
+        build.nodes.push_back({child1, child2});
+
+        return static_cast<int32_t>(build.nodes.size()) - 1;
+    }
+} // Kitsune
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/KitDefinitions.h"
+#include "Core/KitLogs.h"
+#include "Graphics/KitBounds.h"
+
+namespace Kitsune
+{
+    // Dynamic AABB tree over scene objects. Leaves hold boxes fattened by a margin, so small moves cost nothing and
+    // larger ones remove and reinsert a single leaf. Insertion picks the sibling with the lowest surface area cost and
+    // AVL style rotations keep the tree balanced on the way up, Rebuild() re-splits the whole tree when quality drifts.
+    class KitBvh
+    {
+    public:
+        static constexpr int32_t NULL_NODE = -1;
+
+        // Deep enough for any tree the rotations keep balanced, they bound the height to about 1.44 * log2(leaves)
+        static constexpr int32_t MAX_QUERY_DEPTH = 256;
+
+        // Root of a part of a frustum query, is_inside when an ancestor was already found fully inside
+        struct KitBvhSubtree
+        {
+            int32_t node      = NULL_NODE;
+            bool    is_inside = false;
+        };
+
+        // Leaves captured from the tree and the topology split over them. Building touches nothing else, so the slow
+        // part of a rebuild can run on another thread while the tree keeps serving queries and moves.
+        struct KitBvhBuild
+        {
+            // Children come before their parent, the root last. Negative children are leaves, ~child indexes leaves.
+            struct KitBuildNode
+            {
+                int32_t child1 = 0;
+                int32_t child2 = 0;
+            };
+
+            std::vector<int32_t>      leaves;
+            std::vector<KitAabb>      aabbs;
+            std::vector<KitBuildNode> nodes;
+        };
+
+    private:
+        struct KitBvhNode
+        {
+            KitAabb  aabb;
+            uint64_t user_data = 0;
+
+            // Next free node while the node is in the free list
+            int32_t parent = NULL_NODE;
+            int32_t child1 = NULL_NODE;
+            int32_t child2 = NULL_NODE;
+
+            // Leaves are at 0, free nodes at -1
+            int32_t height = -1;
+
+            KIT_NODISCARD bool IsLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        std::vector<KitBvhNode> nodes_;
+        int32_t                 root_        = NULL_NODE;
+        int32_t                 free_list_   = NULL_NODE;
+        uint32_t                proxy_count_ = 0;
+        float                   margin_;
+
+    public:
+        explicit KitBvh(float margin = 0.1f);
+
+        // Returns the proxy id, stable until the proxy is destroyed
+        int32_t CreateProxy(const KitAabb& aabb, uint64_t user_data);
+        void DestroyProxy(int32_t proxy);
+
+        // Refits the proxy to its new box, returns true when the leaf had to be reinserted
+        bool MoveProxy(int32_t proxy, const KitAabb& aabb);
+
+        // Rebuilds the tree top down with median splits along the longest axis, proxy ids are kept. About 80 ms at 100k
+        // proxies, running the three steps below with Build() on a worker leaves about 10 ms of it to the caller.
+        void Rebuild();
+
+        // Copies every leaf and its fat box, linear in the proxy count
+        KIT_NODISCARD KitBvhBuild CaptureBuild() const;
+
+        // Splits the captured leaves, safe on any thread
+        static void Build(KitBvhBuild& build);
+
+        // Replaces the tree by the built one in a single linear pass. Proxies moved since the capture are refit to their
+        // current box, destroyed ones are left out and created ones inserted on top.
+        void ApplyBuild(const KitBvhBuild& build);
+
+        KIT_NODISCARD uint64_t GetUserData(int32_t proxy) const { return nodes_[proxy].user_data; }
+        KIT_NODISCARD const KitAabb& GetFatAabb(int32_t proxy) const { return nodes_[proxy].aabb; }
+        KIT_NODISCARD uint32_t GetProxyCount() const { return proxy_count_; }
+        KIT_NODISCARD int32_t GetHeight() const { return root_ == NULL_NODE ? 0 : nodes_[root_].height; }
+
+        // Summed surface area of the internal nodes over the area of the root, lower is a better tree
+        KIT_NODISCARD float GetAreaRatio() const;
+
+        // Walks the whole tree checking parent links, heights, that every parent contains its children and that the
+        // leaves match the proxy count. Linear in the node count, for tests and debugging.
+        KIT_NODISCARD bool Validate() const;
+
+        // Calls callback(proxy) for every proxy whose fat box overlaps the box
+        template<typename TCallback>
+        void Query(const KitAabb& aabb, TCallback&& callback) const
+        {
+            Traverse(
+                [&aabb](const KitBvhNode& node) { return node.aabb.Overlaps(aabb); },
+                callback);
+        }
+
+        // Calls callback(proxy) for every proxy whose fat box overlaps the sphere
+        template<typename TCallback>
+        void Query(const KitBoundingSphere& sphere, TCallback&& callback) const
+        {
+            Traverse(
+                [&sphere](const KitBvhNode& node) { return sphere.Overlaps(node.aabb); },
+                callback);
+        }
+
+        // Calls callback(proxy, is_inside) for every proxy whose fat box is not outside the frustum.
+        // Subtrees fully inside are reported without testing further, is_inside is true for their proxies.
+        template<typename TCallback>
+        void Query(const KitFrustum& frustum, TCallback&& callback) const
+        {
+            if (root_ != NULL_NODE)
+            {
+                Query(frustum, KitBvhSubtree{root_, false}, callback);
+            }
+        }
+
+        // Splits a frustum query into at least count subtrees when the tree has enough nodes not outside the frustum.
+        // Querying them in order visits the proxies in the same order as a query of the whole tree.
+        void SplitQuery(const KitFrustum& frustum, uint32_t count, std::vector<KitBvhSubtree>& subtrees) const;
+
+        // Frustum query restricted to one subtree from SplitQuery()
+        template<typename TCallback>
+        void Query(const KitFrustum& frustum, const KitBvhSubtree& subtree, TCallback&& callback) const
+        {
+            KitBvhSubtree stack[MAX_QUERY_DEPTH];
+            int32_t       stack_size = 0;
+            stack[stack_size++]      = subtree;
+
+            while (stack_size > 0)
+            {
+                const KitBvhSubtree entry = stack[--stack_size];
+                const KitBvhNode&   node  = nodes_[entry.node];
+
+                bool is_inside = entry.is_inside;
+                if (!is_inside)
+                {
+                    const KitFrustumTest test = frustum.Classify(node.aabb);
+                    if (test == KitFrustumTest::OUTSIDE)
+                    {
+                        continue;
+                    }
+
+                    is_inside = test == KitFrustumTest::INSIDE;
+                }
+
+                if (node.IsLeaf())
+                {
+                    callback(entry.node, is_inside);
+                    continue;
+                }
+
+                KIT_ASSERT(LOG_ENGINE, stack_size + 2 <= MAX_QUERY_DEPTH, "BVH query stack overflow");
+                stack[stack_size++] = {node.child2, is_inside};
+                stack[stack_size++] = {node.child1, is_inside};
+            }
+        }
+
+        // Walks the proxies the ray reaches in order of traversal. callback(proxy, max_distance) returns the distance of
+        // its own hit, or max_distance to ignore the proxy, the ray is clipped to the closest hit so far.
+        template<typename TCallback>
+        void RayCast(const glm::vec3& origin, const glm::vec3& direction, float max_distance, TCallback&& callback) const
+        {
+            if (root_ == NULL_NODE)
+            {
+                return;
+            }
+
+            const glm::vec3 inverse_direction = 1.f / direction;
+
+            int32_t stack[MAX_QUERY_DEPTH];
+            int32_t stack_size  = 0;
+            stack[stack_size++] = root_;
+
+            while (stack_size > 0)
+            {
+                const int32_t     index = stack[--stack_size];
+                const KitBvhNode& node  = nodes_[index];
+
+                float distance;
+                if (!node.aabb.IntersectRay(origin, inverse_direction, max_distance, distance))
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    max_distance = glm::min(max_distance, callback(index, max_distance));
+                    continue;
+                }
+
+                KIT_ASSERT(LOG_ENGINE, stack_size + 2 <= MAX_QUERY_DEPTH, "BVH query stack overflow");
+                stack[stack_size++] = node.child2;
+                stack[stack_size++] = node.child1;
+            }
+        }
+
+    private:
+        template<typename TOverlap, typename TCallback>
+        void Traverse(const TOverlap& overlaps, TCallback& callback) const
+        {
+            if (root_ == NULL_NODE)
+            {
+                return;
+            }
+
+            int32_t stack[MAX_QUERY_DEPTH];
+            int32_t stack_size  = 0;
+            stack[stack_size++] = root_;
+
+            while (stack_size > 0)
+            {
+                const int32_t     index = stack[--stack_size];
+                const KitBvhNode& node  = nodes_[index];
+
+                if (!overlaps(node))
+                {
+                    continue;
+                }
+
+                if (node.IsLeaf())
+                {
+                    callback(index);
+                    continue;
+                }
+
+                KIT_ASSERT(LOG_ENGINE, stack_size + 2 <= MAX_QUERY_DEPTH, "BVH query stack overflow");
+                stack[stack_size++] = node.child2;
+                stack[stack_size++] = node.child1;
+            }
+        }
+
+        int32_t AllocateNode();
+        void FreeNode(int32_t index);
+
+        void InsertLeaf(int32_t leaf);
+        void RemoveLeaf(int32_t leaf);
+
+        // Walks from index to the root rebalancing and refitting every ancestor
+        void Refit(int32_t index);
+
+        // Rotates the taller grandchild up when the children heights differ by more than one, returns the new subtree root
+        int32_t Balance(int32_t index);
+
+        // Splits the leaves in order, centers are indexed like the captured leaves. Returns the child reference of the root.
+        static int32_t BuildTopDown(KitBvhBuild& build, int32_t* order, int32_t count, const std::vector<glm::vec3>& centers);
+    };
+} // Kitsune
@@ -0,0 +1,204 @@
+#include "KitEntityRegistry.h"
+
+#include <algorithm>
+
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    namespace
+    {
+        uint64_t PackHead(const uint32_t index, const uint32_t tag)
+        {
+            return static_cast<uint64_t>(tag) << 32 | index;
+        }
+    }
+
+    KitEntityRegistry::~KitEntityRegistry()
+    {
+        for (std::atomic<KitSlotPage*>& page : pages_)
+        {
+            delete page.load();
+        }
+    }
+
+    KitEntityHandle KitEntityRegistry::Create()
+    {
+        uint32_t index;
+        if (!PopFree(index))
+        {
+            index = AllocateFresh(1);
+            if (index == NULL_INDEX)
+            {
+                return {};
+            }
+        }
+
+        alive_count_.fetch_add(1, std::memory_order_relaxed);
+
+        return KitEntityHandle::Make(index, GetSlot(index).generation.load(std::memory_order_acquire));
+    }
+
+    void KitEntityRegistry::Create(const std::span<KitEntityHandle> handles)
+    {
+        size_t created = 0;
+
+        // Reused slots first, the rest comes from one atomic add
+        uint32_t index;
+        while (created < handles.size() && PopFree(index))
+        {
+            handles[created++] = KitEntityHandle::Make(index, GetSlot(index).generation.load(std::memory_order_acquire));
+        }
+
+        if (created < handles.size())
+        {
+            const uint32_t count = static_cast<uint32_t>(handles.size() - created);
+            const uint32_t first = AllocateFresh(count);
+
+            // All or nothing, the handles past the reused ones stay null
+            if (first == NULL_INDEX)
+            {
+                std::fill(handles.begin() + created, handles.end(), KitEntityHandle{});
+                alive_count_.fetch_add(static_cast<uint32_t>(created), std::memory_order_relaxed);
+                return;
+            }
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                handles[created++] = KitEntityHandle::Make(first + i, 0);
+            }
+        }
+
+        alive_count_.fetch_add(static_cast<uint32_t>(handles.size()), std::memory_order_relaxed);
+    }
+
+    void KitEntityRegistry::Destroy(const KitEntityHandle handle)
+    {
+        KIT_ASSERT(LOG_ENGINE, IsValid(handle), "Destroying stale entity handle {:#x}", handle.value);
+
+        const uint32_t index = handle.GetIndex();
+        GetSlot(index).generation.store((handle.GetGeneration() + 1) & KitEntityHandle::GENERATION_MASK,
+                                        std::memory_order_release);
+
+        PushFree(index, index);
+        alive_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void KitEntityRegistry::Destroy(const std::span<const KitEntityHandle> handles)
+    {
+        if (handles.empty())
+        {
+            return;
+        }
+
+        // Linked into one chain first, the free list sees a single push
+        for (size_t i = 0; i < handles.size(); i++)
+        {
+            const KitEntityHandle handle = handles[i];
+            KIT_ASSERT(LOG_ENGINE, IsValid(handle), "Destroying stale entity handle {:#x}", handle.value);
+
+            KitSlot& slot = GetSlot(handle.GetIndex());
+            slot.generation.store((handle.GetGeneration() + 1) & KitEntityHandle::GENERATION_MASK, std::memory_order_release);
+
+            if (i + 1 < handles.size())
+            {
+                slot.next_free.store(handles[i + 1].GetIndex(), std::memory_order_relaxed);
+            }
+        }
+
+        PushFree(handles.front().GetIndex(), handles.back().GetIndex());
+        alive_count_.fetch_sub(static_cast<uint32_t>(handles.size()), std::memory_order_relaxed);
+    }
+
+    bool KitEntityRegistry::IsValid(const KitEntityHandle handle) const
+    {
+        const uint32_t index = handle.GetIndex();
+        if (handle.IsNull() || index >= next_index_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        const KitSlotPage* page = pages_[index / PAGE_SIZE].load(std::memory_order_acquire);
+        return page != nullptr &&
+               page->slots[index % PAGE_SIZE].generation.load(std::memory_order_acquire) == handle.GetGeneration();
+    }
+
+    KitEntityRegistry::KitSlot& KitEntityRegistry::GetSlot(const uint32_t index) const
+    {
+        return pages_[index / PAGE_SIZE].load(std::memory_order_acquire)->slots[index % PAGE_SIZE];
+    }
+
+    uint32_t KitEntityRegistry::AllocateFresh(const uint32_t count)
+    {
+        // Checked in every build, a fetch add past the end would index pages_ out of bounds
+        uint32_t first = next_index_.load(std::memory_order_acquire);
+        do
+        {
+            if (count > MAX_ENTITIES - first)
+            {
+                KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_ERROR, "Entity registry is full, {} entities at most", MAX_ENTITIES);
+                return NULL_INDEX;
+            }
+        }
+        while (!next_index_.compare_exchange_weak(first, first + count, std::memory_order_acq_rel));
+
+        // Several threads can reach a new page at once, one of them publishes its page and the others drop theirs
+        for (uint32_t page_index = first / PAGE_SIZE; page_index <= (first + count - 1) / PAGE_SIZE; page_index++)
+        {
+            std::atomic<KitSlotPage*>& page = pages_[page_index];
+            if (page.load(std::memory_order_acquire) != nullptr)
+            {
+                continue;
+            }
+
+            KitSlotPage* new_page = new KitSlotPage();
+            KitSlotPage* expected = nullptr;
+            if (!page.compare_exchange_strong(expected, new_page, std::memory_order_acq_rel))
+            {
+                delete new_page;
+            }
+        }
+
+        return first;
+    }
+
+    bool KitEntityRegistry::PopFree(uint32_t& index)
+    {
+        uint64_t head = free_head_.load(std::memory_order_acquire);
+        while (true)
+        {
+            const uint32_t top = static_cast<uint32_t>(head);
+            if (top == NULL_INDEX)
+            {
+                return false;
+            }
+
+            // The tag makes the exchange fail if top was popped and pushed back meanwhile, its next_free may have changed
+            const uint32_t next = GetSlot(top).next_free.load(std::memory_order_relaxed);
+            const uint32_t tag  = static_cast<uint32_t>(head >> 32) + 1;
+
+            if (free_head_.compare_exchange_weak(head, PackHead(next, tag), std::memory_order_acq_rel))
+            {
+                index = top;
+                return true;
+            }
+        }
+    }
+
+    void KitEntityRegistry::PushFree(const uint32_t first, const uint32_t last)
+    {
+        KitSlot& last_slot = GetSlot(last);
+
+        uint64_t head = free_head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            last_slot.next_free.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+
+            const uint32_t tag = static_cast<uint32_t>(head >> 32) + 1;
+            if (free_head_.compare_exchange_weak(head, PackHead(first, tag), std::memory_order_release))
+            {
+                return;
+            }
+        }
+    }
+} // Kitsune
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <span>
+
+#include "Core/KitDefinitions.h"
+
+namespace Kitsune
+{
+    // 20 bit slot index and 12 bit generation, a destroyed handle stops matching its slot once the generation moved on
+    struct KitEntityHandle
+    {
+        static constexpr uint32_t INDEX_BITS      = 20;
+        static constexpr uint32_t INDEX_MASK      = (1u << INDEX_BITS) - 1;
+        static constexpr uint32_t GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+        static constexpr uint32_t NULL_VALUE      = UINT32_MAX;
+
+        uint32_t value = NULL_VALUE;
+
+        static KitEntityHandle Make(const uint32_t index, const uint32_t generation)
+        {
+            return {index | (generation & GENERATION_MASK) << INDEX_BITS};
+        }
+
+        KIT_NODISCARD uint32_t GetIndex() const { return value & INDEX_MASK; }
+        KIT_NODISCARD uint32_t GetGeneration() const { return value >> INDEX_BITS; }
+        KIT_NODISCARD bool IsNull() const { return value == NULL_VALUE; }
+
+        bool operator==(const KitEntityHandle& other) const = default;
+    };
+
+    // Hands out entity handles from any thread without locks. Destroyed slots go on a lock free free list, a stack
+    // whose head carries a tag against ABA, and are reused with a bumped generation. Bulk creation takes every fresh slot
+    // it needs with a single atomic add, so loader threads spawning in batches do not contend with each other.
+    // Validating a handle is an array lookup and a compare, no hashing.
+    class KitEntityRegistry
+    {
+    public:
+        static constexpr uint32_t PAGE_SIZE = 4096;
+
+        // The all ones index is left out, it belongs to the null handle
+        static constexpr uint32_t MAX_ENTITIES = KitEntityHandle::INDEX_MASK;
+        static constexpr uint32_t PAGE_COUNT   = (MAX_ENTITIES + PAGE_SIZE - 1) / PAGE_SIZE;
+
+    private:
+        static constexpr uint32_t NULL_INDEX = UINT32_MAX;
+
+        struct KitSlot
+        {
+            std::atomic<uint32_t> generation{0};
+            std::atomic<uint32_t> next_free{NULL_INDEX};
+        };
+
+        struct KitSlotPage
+        {
+            KitSlot slots[PAGE_SIZE];
+        };
+
+        // Pages are created by the first thread reaching them and never move, slots stay valid without locking
+        std::array<std::atomic<KitSlotPage*>, PAGE_COUNT> pages_{};
+
+        // Index of the top free slot in the low half, a tag bumped by every change in the high half
+        std::atomic<uint64_t> free_head_{NULL_INDEX};
+
+        std::atomic<uint32_t> next_index_{0};
+        std::atomic<uint32_t> alive_count_{0};
+
+    public:
+        KitEntityRegistry() = default;
+        ~KitEntityRegistry();
+
+        KitEntityRegistry(const KitEntityRegistry&)            = delete;
+        KitEntityRegistry& operator=(const KitEntityRegistry&) = delete;
+
+        // A full registry hands out null handles
+        KitEntityHandle Create();
+        void Create(std::span<KitEntityHandle> handles);
+
+        void Destroy(KitEntityHandle handle);
+        void Destroy(std::span<const KitEntityHandle> handles);
+
+        KIT_NODISCARD bool IsValid(KitEntityHandle handle) const;
+        KIT_NODISCARD uint32_t GetAliveCount() const { return alive_count_.load(std::memory_order_relaxed); }
+
+    private:
+        KIT_NODISCARD KitSlot& GetSlot(uint32_t index) const;
+
+        // Takes count never used slots, creating their pages as needed, returns the first index or NULL_INDEX when they
+        // do not fit
+        uint32_t AllocateFresh(uint32_t count);
+
+        bool PopFree(uint32_t& index);
+
+        // Pushes the chain first -> ... -> last, already linked through next_free
+        void PushFree(uint32_t first, uint32_t last);
+    };
+} // Kitsune
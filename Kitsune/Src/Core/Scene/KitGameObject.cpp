@@ -1,10 +0,0 @@
-﻿#include "KitGameObject.h"
-
-namespace Kitsune
-{
-
-    KitGameObject::KitGameObject(const KitGameObjID id):
-        id_(id)
-    {
-    }
-}
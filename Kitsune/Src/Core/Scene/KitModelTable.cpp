@@ -0,0 +1,76 @@
+#include "KitModelTable.h"
+
+#include "Core/KitLogs.h"
+#include "Graphics/KitModel.h"
+
+namespace Kitsune
+{
+    KitModelHandle KitModelTable::Acquire(std::shared_ptr<KitModel> model)
+    {
+        if (model == nullptr)
+        {
+            return INVALID_MODEL_HANDLE;
+        }
+
+        if (const auto it = handles_.find(model.get()); it != handles_.end())
+        {
+            use_counts_[it->second]++;
+            return it->second;
+        }
+
+        KitModelHandle handle;
+        if (free_handles_.empty())
+        {
+            handle = static_cast<KitModelHandle>(models_.size());
+            models_.emplace_back();
+            use_counts_.push_back(0);
+            mesh_versions_.push_back(0);
+        }
+        else
+        {
+            handle = free_handles_.back();
+            free_handles_.pop_back();
+        }
+
+        handles_[model.get()]  = handle;
+        mesh_versions_[handle] = model->GetMeshVersion();
+        models_[handle]        = std::move(model);
+        use_counts_[handle]    = 1;
+
+        return handle;
+    }
+
+    void KitModelTable::Release(const KitModelHandle handle)
+    {
+        if (handle == INVALID_MODEL_HANDLE)
+        {
+            return;
+        }
+
+        KIT_ASSERT(LOG_ENGINE, handle < models_.size() && use_counts_[handle] > 0, "Releasing unused model handle {}", handle);
+
+        if (--use_counts_[handle] > 0)
+        {
+            return;
+        }
+
+        handles_.erase(models_[handle].get());
+        models_[handle].reset();
+        free_handles_.push_back(handle);
+    }
+
+    void KitModelTable::CollectReloadedModels(std::vector<KitModelHandle>& reloaded_models)
+    {
+        for (KitModelHandle handle = 0; handle < models_.size(); handle++)
+        {
+            const KitModel* model = models_[handle].get();
+            if (model == nullptr || model->GetMeshVersion() == mesh_versions_[handle])
+            {
+                continue;
+            }
+
+            mesh_versions_[handle] = model->GetMeshVersion();
+            reloaded_models.push_back(handle);
+        }
+    }
+} // Kitsune
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/KitDefinitions.h"
+#include "Components/KitRenderComponents.h"
+
+namespace Kitsune
+{
+    // Dense table of the models used by a scene. Entities keep a 4 byte handle instead of a shared_ptr each, the table
+    // holds one shared_ptr per model and counts the entities using it without atomics, scene edits are single threaded.
+    // Slots of models no entity uses anymore are reused by later models.
+    class KitModelTable
+    {
+        std::vector<std::shared_ptr<KitModel>> models_;
+        std::vector<uint32_t>                  use_counts_;
+        std::vector<uint32_t>                  mesh_versions_;
+        std::vector<KitModelHandle>            free_handles_;
+
+        std::unordered_map<const KitModel*, KitModelHandle> handles_;
+
+    public:
+        // Handle of the model, the same model always maps to the same handle while it is in use
+        KitModelHandle Acquire(std::shared_ptr<KitModel> model);
+        void Release(KitModelHandle handle);
+
+        // Appends the models whose meshes were swapped since the last call
+        void CollectReloadedModels(std::vector<KitModelHandle>& reloaded_models);
+
+        KIT_NODISCARD KitModel* Get(const KitModelHandle handle) const
+        {
+            return handle < models_.size() ? models_[handle].get() : nullptr;
+        }
+
+        KIT_NODISCARD size_t GetModelCount() const { return handles_.size(); }
+    };
+} // Kitsune
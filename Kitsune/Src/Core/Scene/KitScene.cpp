@@ -0,0 +1,393 @@
+#include "KitScene.h"
+
+#include "Core/KitJobSystem.h"
+#include "Graphics/KitModel.h"
+
+namespace Kitsune
+{
+    KitScene::KitScene()
+    {
+        world_.component<KitEntityHandle>();
+        world_.component<KitTransform>();
+        world_.component<KitWorldTransform>();
+        world_.component<KitModelComponent>();
+        world_.component<KitColorComponent>();
+        world_.component<KitBvhProxyComponent>();
+        world_.component<KitPointLightComponent>();
+
+        renderable_query_  = world_.query_builder<const KitWorldTransform, const KitModelComponent>().cached().build();
+        point_light_query_ = world_.query_builder<KitTransform, const KitWorldTransform, const KitColorComponent,
+                                                  const KitPointLightComponent>()
+                                   .cached()
+                                   .build();
+    }
+
+    flecs::entity KitScene::CreateEntity(const KitTransform& transform, KitEntityHandle handle)
+    {
+        if (handle.IsNull())
+        {
+            handle = registry_.Create();
+        }
+
+        flecs::entity entity = world_.entity().set<KitEntityHandle>(handle).set<KitTransform>(transform).add<KitWorldTransform>();
+        MarkTransformDirty(entity);
+
+        // The registry is full, the entity exists but cannot be looked up by handle
+        if (handle.IsNull())
+        {
+            return entity;
+        }
+
+        KIT_ASSERT(LOG_ENGINE, registry_.IsValid(handle), "Creating an entity with stale handle {:#x}", handle.value);
+
+        const uint32_t index = handle.GetIndex();
+        if (index >= handle_entities_.size())
+        {
+            handle_entities_.resize(index + 1);
+        }
+
+        handle_entities_[index] = entity;
+
+        return entity;
+    }
+
+    flecs::entity KitScene::CreateModelEntity(
+        std::shared_ptr<KitModel> model,
+        const KitTransform&       transform,
+        const KitEntityHandle     handle)
+    {
+        return CreateEntity(transform, handle)
+               .set<KitModelComponent>({models_.Acquire(std::move(model))})
+               .add<KitBvhProxyComponent>();
+    }
+
+    flecs::entity KitScene::CreatePointLight(const float intensity, const float radius, const glm::vec3& color)
+    {
+        KitTransform transform;
+        transform.scale.x = radius;
+
+        return CreateEntity(transform)
+               .set<KitColorComponent>({color})
+               .set<KitPointLightComponent>({intensity});
+    }
+
+    void KitScene::DestroyEntity(const flecs::entity entity)
+    {
+        if (!hierarchy_.Contains(entity))
+        {
+            DestructEntity(entity);
+        }
+        else
+        {
+            for (const flecs::entity removed_entity : hierarchy_.Remove(entity))
+            {
+                DestructEntity(removed_entity);
+            }
+        }
+
+        ReleaseDestroyedHandles();
+    }
+
+    flecs::entity KitScene::GetEntity(const KitEntityHandle handle) const
+    {
+        if (!registry_.IsValid(handle) || handle.GetIndex() >= handle_entities_.size())
+        {
+            return flecs::entity();
+        }
+
+        return handle_entities_[handle.GetIndex()];
+    }
+
+    KitEntityHandle KitScene::GetHandle(const flecs::entity entity)
+    {
+        const KitEntityHandle* handle = entity.get<KitEntityHandle>();
+        return handle != nullptr ? *handle : KitEntityHandle{};
+    }
+
+    void KitScene::SetParent(const flecs::entity entity, const flecs::entity parent)
+    {
+        hierarchy_.SetParent(entity, parent);
+
+        // Entities that just joined the hierarchy need their local matrices
+        MarkTransformDirty(entity);
+        if (parent.is_valid())
+        {
+            MarkTransformDirty(parent);
+        }
+    }
+
+    void KitScene::SetTransform(const flecs::entity entity, const KitTransform& transform)
+    {
+        entity.set<KitTransform>(transform);
+        MarkTransformDirty(entity);
+    }
+
+    void KitScene::MarkTransformDirty(const flecs::entity entity)
+    {
+        KitWorldTransform* world_transform = entity.get_mut<KitWorldTransform>();
+        if (world_transform == nullptr || world_transform->is_dirty)
+        {
+            return;
+        }
+
+        world_transform->is_dirty = true;
+        dirty_transforms_.push_back(entity);
+    }
+
+    void KitScene::OnModelReloaded(const KitModelHandle handle)
+    {
+        renderable_query_.each(
+            [this, handle](const flecs::entity entity, const KitWorldTransform&, const KitModelComponent& model_component)
+        {
+            if (model_component.model != handle)
+            {
+                return;
+            }
+
+            // The fat box of a model that shrank would still contain the new one and never be refit, start over
+            if (KitBvhProxyComponent* proxy_component = entity.get_mut<KitBvhProxyComponent>();
+                proxy_component != nullptr && proxy_component->proxy != KitBvh::NULL_NODE)
+            {
+                bvh_.DestroyProxy(proxy_component->proxy);
+                proxy_component->proxy = KitBvh::NULL_NODE;
+            }
+
+            MarkTransformDirty(entity);
+        });
+    }
+
+    void KitScene::UpdateTransforms(KitJobSystem* job_system)
+    {
+        updated_transform_count_ = 0;
+
+        reloaded_models_.clear();
+        models_.CollectReloadedModels(reloaded_models_);
+        for (const KitModelHandle handle : reloaded_models_)
+        {
+            OnModelReloaded(handle);
+        }
+
+        transform_batch_.Clear();
+        batched_entities_.clear();
+
+        for (const flecs::entity entity : dirty_transforms_)
+        {
+            // Destroyed after being marked
+            if (!entity.is_alive())
+            {
+                continue;
+            }
+
+            transform_batch_.Add(*entity.get<KitTransform>());
+            batched_entities_.push_back(entity);
+        }
+
+        dirty_transforms_.clear();
+
+        model_matrices_.resize(batched_entities_.size());
+        normal_matrices_.resize(batched_entities_.size());
+
+        transform_batch_.Compute(model_matrices_.data(), normal_matrices_.data());
+
+        for (size_t i = 0; i < batched_entities_.size(); i++)
+        {
+            const flecs::entity entity          = batched_entities_[i];
+            KitWorldTransform*  world_transform = entity.get_mut<KitWorldTransform>();
+            world_transform->is_dirty           = false;
+
+            // Matrices of attached entities are relative to their parent, they reach the world transform below
+            if (hierarchy_.Contains(entity))
+            {
+                hierarchy_.SetLocalMatrices(entity, model_matrices_[i], normal_matrices_[i]);
+                continue;
+            }
+
+            world_transform->model_matrix  = model_matrices_[i];
+            world_transform->normal_matrix = normal_matrices_[i];
+            updated_transform_count_++;
+
+            UpdateBounds(entity, model_matrices_[i]);
+        }
+
+        updated_transform_count_ += hierarchy_.Propagate(
+            [this](const flecs::entity entity, const glm::mat4& model_matrix, const glm::mat4& normal_matrix)
+            {
+                if (KitWorldTransform* world_transform = entity.get_mut<KitWorldTransform>())
+                {
+                    world_transform->model_matrix  = model_matrix;
+                    world_transform->normal_matrix = normal_matrix;
+
+                    UpdateBounds(entity, model_matrix);
+                }
+            });
+
+        RebalanceBvh(job_system);
+    }
+
+    void KitScene::SetModelChangeTracking(const bool is_enabled)
+    {
+        is_tracking_model_changes_ = is_enabled;
+        ClearModelChanges();
+
+        if (is_enabled)
+        {
+            renderable_query_.each([this](const flecs::entity entity, const KitWorldTransform&, const KitModelComponent&)
+            {
+                changed_models_.push_back(entity);
+            });
+        }
+    }
+
+    void KitScene::ClearModelChanges()
+    {
+        changed_models_.clear();
+        removed_models_.clear();
+    }
+
+    flecs::entity KitScene::Pick(const glm::vec3& origin, const glm::vec3& direction, const float max_distance) const
+    {
+        const glm::vec3 inverse_direction = 1.f / direction;
+
+        flecs::entity picked_entity;
+
+        // Fat boxes only narrow the search down, each candidate is tested against its exact world box
+        const auto test_candidate = [this, &origin, &inverse_direction, &picked_entity](
+            const int32_t proxy,
+            const float   closest_distance)
+        {
+            const flecs::entity      entity          = GetEntity(bvh_.GetUserData(proxy));
+            const KitWorldTransform* world_transform = entity.get<KitWorldTransform>();
+            const KitModelComponent* model_component = entity.get<KitModelComponent>();
+            const KitModel*          model           = model_component != nullptr ? GetModel(model_component->model) : nullptr;
+
+            if (world_transform == nullptr || model == nullptr)
+            {
+                return closest_distance;
+            }
+
+            const KitAabb aabb = model->GetBounds().aabb.Transform(world_transform->model_matrix);
+
+            float distance;
+            if (!aabb.IntersectRay(origin, inverse_direction, closest_distance, distance))
+            {
+                return closest_distance;
+            }
+
+            picked_entity = entity;
+            return distance;
+        };
+
+        bvh_.RayCast(origin, direction, max_distance, test_candidate);
+
+        return picked_entity;
+    }
+
+    void KitScene::DestructEntity(const flecs::entity entity)
+    {
+        if (const KitBvhProxyComponent* proxy_component = entity.get<KitBvhProxyComponent>();
+            proxy_component != nullptr && proxy_component->proxy != KitBvh::NULL_NODE)
+        {
+            bvh_.DestroyProxy(proxy_component->proxy);
+        }
+
+        if (const KitModelComponent* model_component = entity.get<KitModelComponent>())
+        {
+            models_.Release(model_component->model);
+
+            if (is_tracking_model_changes_)
+            {
+                removed_models_.push_back(GetHandle(entity));
+            }
+        }
+
+        if (const KitEntityHandle* handle = entity.get<KitEntityHandle>(); handle != nullptr && !handle->IsNull())
+        {
+            handle_entities_[handle->GetIndex()] = flecs::entity();
+            destroyed_handles_.push_back(*handle);
+        }
+
+        entity.destruct();
+    }
+
+    void KitScene::ReleaseDestroyedHandles()
+    {
+        registry_.Destroy(destroyed_handles_);
+        destroyed_handles_.clear();
+    }
+
+    void KitScene::UpdateBounds(const flecs::entity entity, const glm::mat4& model_matrix)
+    {
+        KitBvhProxyComponent*    proxy_component = entity.get_mut<KitBvhProxyComponent>();
+        const KitModelComponent* model_component = entity.get<KitModelComponent>();
+        const KitModel*          model           = model_component != nullptr ? GetModel(model_component->model) : nullptr;
+
+        if (proxy_component == nullptr || model == nullptr)
+        {
+            return;
+        }
+
+        if (is_tracking_model_changes_)
+        {
+            changed_models_.push_back(entity);
+        }
+
+        const KitAabb aabb = model->GetBounds().aabb.Transform(model_matrix);
+
+        if (proxy_component->proxy == KitBvh::NULL_NODE)
+        {
+            proxy_component->proxy = bvh_.CreateProxy(aabb, entity.id());
+        }
+        else
+        {
+            bvh_.MoveProxy(proxy_component->proxy, aabb);
+        }
+    }
+
+    void KitScene::RebalanceBvh(KitJobSystem* job_system)
+    {
+        if (bvh_build_.valid())
+        {
+            if (bvh_build_.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                bvh_.ApplyBuild(bvh_build_.get());
+                OnBvhRebuilt();
+            }
+
+            return;
+        }
+
+        if (++frames_since_rebalance_ < REBALANCE_INTERVAL)
+        {
+            return;
+        }
+
+        frames_since_rebalance_ = 0;
+
+        // Incremental insertions only look at the path they take, the tree slowly degrades as objects move around
+        if (bvh_.GetAreaRatio() <= rebalanced_area_ratio_ * REBALANCE_THRESHOLD)
+        {
+            return;
+        }
+
+        if (job_system == nullptr)
+        {
+            bvh_.Rebuild();
+            OnBvhRebuilt();
+            return;
+        }
+
+        bvh_build_ = job_system->Submit([build = bvh_.CaptureBuild()]() mutable
+        {
+            KitBvh::Build(build);
+            return std::move(build);
+        });
+    }
+
+    void KitScene::OnBvhRebuilt()
+    {
+        rebalanced_area_ratio_ = bvh_.GetAreaRatio();
+
+        KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_INFO, "Rebuilt scene BVH of {} objects, area ratio {:.2f}",
+                bvh_.GetProxyCount(), rebalanced_area_ratio_);
+    }
+} // Kitsune
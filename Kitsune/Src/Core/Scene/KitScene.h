@@ -0,0 +1,150 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <vector>
+
+#include <flecs.h>
+
+#include "Core/KitDefinitions.h"
+#include "Components/KitLightComponents.h"
+#include "Components/KitRenderComponents.h"
+#include "Components/KitTransformComponent.h"
+#include "KitBvh.h"
+#include "KitEntityRegistry.h"
+#include "KitModelTable.h"
+#include "KitSceneHierarchy.h"
+#include "KitTransformBatch.h"
+
+namespace Kitsune
+{
+    class KitJobSystem;
+
+    using KitRenderableQuery = flecs::query<const KitWorldTransform, const KitModelComponent>;
+    using KitPointLightQuery =
+        flecs::query<KitTransform, const KitWorldTransform, const KitColorComponent, const KitPointLightComponent>;
+
+    // Entities and their components, stored by flecs in archetype tables.
+    // Systems iterate the cached queries below, which only visit the tables holding every component they ask for.
+    class KitScene
+    {
+        // Frames between BVH quality checks, and how much worse than after the last build it may get before a rebuild.
+        // A rebuild at 100k objects takes tens of milliseconds, given a job system it runs on a worker and the tree is
+        // swapped a few frames later.
+        static constexpr uint32_t REBALANCE_INTERVAL  = 256;
+        static constexpr float    REBALANCE_THRESHOLD = 1.5f;
+
+        flecs::world world_;
+
+        // Every entity carries a KitEntityHandle component, resolved back through the slot array
+        KitEntityRegistry            registry_;
+        std::vector<flecs::entity>   handle_entities_;
+        std::vector<KitEntityHandle> destroyed_handles_;
+
+        KitRenderableQuery renderable_query_;
+        KitPointLightQuery point_light_query_;
+
+        KitSceneHierarchy hierarchy_;
+        KitModelTable     models_;
+
+        // World space boxes of every model entity, backs culling and picking
+        KitBvh   bvh_;
+        uint32_t frames_since_rebalance_ = 0;
+        float    rebalanced_area_ratio_  = 0.f;
+
+        // Rebuilt on a worker from the leaves captured when it started, the live tree keeps serving until it is applied
+        std::future<KitBvh::KitBvhBuild> bvh_build_;
+
+        std::vector<flecs::entity> dirty_transforms_;
+        size_t                     updated_transform_count_ = 0;
+
+        // Model entities whose world matrix or model meshes changed and handles of destroyed model entities since the
+        // last ClearModelChanges, for renderers keeping their own copy of the scene on the GPU
+        bool                         is_tracking_model_changes_ = false;
+        std::vector<flecs::entity>   changed_models_;
+        std::vector<KitEntityHandle> removed_models_;
+
+        // Scratch reused every frame, the dirty transforms are computed in one batch
+        KitTransformBatch           transform_batch_;
+        std::vector<flecs::entity>  batched_entities_;
+        std::vector<glm::mat4>      model_matrices_;
+        std::vector<glm::mat4>      normal_matrices_;
+        std::vector<KitModelHandle> reloaded_models_;
+
+    public:
+        KitScene();
+
+        KitScene(const KitScene&) = delete;
+        KitScene& operator=(const KitScene&) = delete;
+
+        // A null handle allocates a new one, loader threads can reserve handles from the registry and spawn with them later
+        flecs::entity CreateEntity(const KitTransform& transform = {}, KitEntityHandle handle = {});
+        flecs::entity CreateModelEntity(
+            std::shared_ptr<KitModel> model,
+            const KitTransform&       transform = {},
+            KitEntityHandle           handle    = {});
+        flecs::entity CreatePointLight(
+            float            intensity = 10.f,
+            float            radius    = 0.1f,
+            const glm::vec3& color     = glm::vec3(1.0f, 1.0f, 1.0f));
+
+        // Destroys the entity together with its children
+        void DestroyEntity(flecs::entity entity);
+
+        // Attaches entity and its children under parent, a null parent detaches it. Its transform becomes relative to the parent.
+        void SetParent(flecs::entity entity, flecs::entity parent);
+        KIT_NODISCARD flecs::entity GetParent(const flecs::entity entity) const { return hierarchy_.GetParent(entity); }
+
+        // Transforms edited in place must be marked so their world matrices get rebuilt
+        void SetTransform(flecs::entity entity, const KitTransform& transform);
+        void MarkTransformDirty(flecs::entity entity);
+
+        // Refits the boxes of every entity using the model and reports them as changed, once its meshes were swapped by a
+        // reload. UpdateTransforms calls it for the models reloaded since the previous frame.
+        void OnModelReloaded(KitModelHandle handle);
+
+        // Rebuilds the world matrices of the transforms marked since the last call and of their children, once per frame
+        // before rendering. The cost follows the number of moved entities, static ones are never touched. Without a job
+        // system the occasional BVH rebuild runs inline.
+        void UpdateTransforms(KitJobSystem* job_system = nullptr);
+
+        // Closest model entity whose world box the ray hits, a null entity when there is none
+        KIT_NODISCARD flecs::entity Pick(const glm::vec3& origin, const glm::vec3& direction, float max_distance) const;
+
+        KIT_NODISCARD flecs::world& GetWorld() { return world_; }
+        KIT_NODISCARD flecs::entity GetEntity(const uint64_t id) const { return world_.get_alive(id); }
+
+        // Null entity for stale handles, checked against the slot generation without any hashing
+        KIT_NODISCARD flecs::entity GetEntity(KitEntityHandle handle) const;
+        KIT_NODISCARD static KitEntityHandle GetHandle(flecs::entity entity);
+
+        // Thread safe, unlike the rest of the scene
+        KIT_NODISCARD KitEntityRegistry& GetRegistry() { return registry_; }
+
+        KIT_NODISCARD const KitBvh& GetBvh() const { return bvh_; }
+        KIT_NODISCARD KitModel* GetModel(const KitModelHandle handle) const { return models_.Get(handle); }
+        KIT_NODISCARD const KitRenderableQuery& GetRenderableQuery() const { return renderable_query_; }
+        KIT_NODISCARD const KitPointLightQuery& GetPointLightQuery() const { return point_light_query_; }
+        KIT_NODISCARD size_t GetUpdatedTransformCount() const { return updated_transform_count_; }
+
+        // Turning tracking on reports every existing model entity as changed
+        void SetModelChangeTracking(bool is_enabled);
+        void ClearModelChanges();
+
+        KIT_NODISCARD bool IsTrackingModelChanges() const { return is_tracking_model_changes_; }
+
+        // A changed entity may have been destroyed since, removals are listed by handle
+        KIT_NODISCARD const std::vector<flecs::entity>& GetChangedModels() const { return changed_models_; }
+        KIT_NODISCARD const std::vector<KitEntityHandle>& GetRemovedModels() const { return removed_models_; }
+
+    private:
+        // Destructs the entity and queues its handle, the caller releases the queued handles in one go
+        void DestructEntity(flecs::entity entity);
+        void ReleaseDestroyedHandles();
+
+        // Inserts or refits the BVH leaf of a model entity after its world matrix changed
+        void UpdateBounds(flecs::entity entity, const glm::mat4& model_matrix);
+        void RebalanceBvh(KitJobSystem* job_system);
+        void OnBvhRebuilt();
+    };
+} // Kitsune
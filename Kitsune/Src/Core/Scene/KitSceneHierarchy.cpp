@@ -0,0 +1,249 @@
+#include "KitSceneHierarchy.h"
+
+#include <algorithm>
+
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    void KitSceneHierarchy::SetParent(const flecs::entity entity, const flecs::entity parent)
+    {
+        const auto it = indices_.find(entity.id());
+        uint32_t index = it != indices_.end() ? it->second : AddRoot(entity);
+
+        uint32_t parent_index = INVALID_INDEX;
+        if (parent.is_valid())
+        {
+            const auto parent_it = indices_.find(parent.id());
+            parent_index = parent_it != indices_.end() ? parent_it->second : AddRoot(parent);
+        }
+
+        const uint32_t count = subtree_sizes_[index];
+        KIT_ASSERT(LOG_ENGINE, parent_index == INVALID_INDEX || parent_index < index || parent_index >= index + count,
+                   "Cannot parent entity {} to its own descendant {}", entity.id(), parent.id());
+
+        if (parents_[index] == parent_index)
+        {
+            return;
+        }
+
+        const flecs::entity old_parent = parents_[index] != INVALID_INDEX ? entities_[parents_[index]] : flecs::entity();
+
+        // The subtree goes at the end of the new parent's range, or at the end of the array for a new root.
+        // Sizes still describe the current layout here, they are fixed up once the nodes moved.
+        const uint32_t destination = parent_index == INVALID_INDEX
+                                         ? static_cast<uint32_t>(entities_.size())
+                                         : parent_index + subtree_sizes_[parent_index];
+
+        if (destination > index + count)
+        {
+            Rotate(index, index + count, destination);
+            index = destination - count;
+        }
+        else if (destination < index)
+        {
+            Rotate(destination, index, index + count);
+            index = destination;
+        }
+
+        if (old_parent.is_valid())
+        {
+            AddToAncestorSizes(indices_.at(old_parent.id()), -static_cast<int64_t>(count));
+        }
+
+        parent_index    = parent.is_valid() ? indices_.at(parent.id()) : INVALID_INDEX;
+        parents_[index] = parent_index;
+        AddToAncestorSizes(parent_index, count);
+
+        dirty_nodes_.push_back(entity.id());
+    }
+
+    std::vector<flecs::entity> KitSceneHierarchy::Remove(const flecs::entity entity)
+    {
+        const auto it = indices_.find(entity.id());
+        if (it == indices_.end())
+        {
+            return {};
+        }
+
+        const uint32_t index = it->second;
+        const uint32_t count = subtree_sizes_[index];
+        const uint32_t end   = index + count;
+
+        AddToAncestorSizes(parents_[index], -static_cast<int64_t>(count));
+
+        std::vector<flecs::entity> removed(entities_.begin() + index, entities_.begin() + end);
+        for (const flecs::entity removed_entity : removed)
+        {
+            indices_.erase(removed_entity.id());
+        }
+
+        const auto erase_range = [index, end](auto& nodes)
+        {
+            nodes.erase(nodes.begin() + index, nodes.begin() + end);
+        };
+
+        erase_range(entities_);
+        erase_range(parents_);
+        erase_range(subtree_sizes_);
+        erase_range(local_matrices_);
+        erase_range(local_normal_matrices_);
+        erase_range(world_matrices_);
+        erase_range(world_normal_matrices_);
+
+        // Only nodes after the removed range moved, nothing outside it had a parent inside it
+        for (uint32_t i = index; i < entities_.size(); i++)
+        {
+            indices_[entities_[i].id()] = i;
+        }
+
+        for (uint32_t i = index; i < parents_.size(); i++)
+        {
+            if (parents_[i] != INVALID_INDEX && parents_[i] >= end)
+            {
+                parents_[i] -= count;
+            }
+        }
+
+        return removed;
+    }
+
+    void KitSceneHierarchy::SetLocalMatrices(
+        const flecs::entity entity,
+        const glm::mat4&    model_matrix,
+        const glm::mat4&    normal_matrix)
+    {
+        const uint32_t index = indices_.at(entity.id());
+
+        local_matrices_[index]        = model_matrix;
+        local_normal_matrices_[index] = normal_matrix;
+
+        dirty_nodes_.push_back(entity.id());
+    }
+
+    size_t KitSceneHierarchy::Propagate(const KitWorldMatrixCallback& callback)
+    {
+        dirty_indices_.clear();
+
+        for (const flecs::entity_t id : dirty_nodes_)
+        {
+            // Removed after being marked
+            if (const auto it = indices_.find(id); it != indices_.end())
+            {
+                dirty_indices_.push_back(it->second);
+            }
+        }
+
+        dirty_nodes_.clear();
+
+        // Sorted, a dirty node inside a subtree that was already walked is skipped
+        std::ranges::sort(dirty_indices_);
+
+        size_t   propagated_count = 0;
+        uint32_t walked_end       = 0;
+
+        for (const uint32_t index : dirty_indices_)
+        {
+            if (index < walked_end)
+            {
+                continue;
+            }
+
+            walked_end = index + subtree_sizes_[index];
+
+            // Parents precede children, each node reads an already updated parent
+            for (uint32_t i = index; i < walked_end; i++)
+            {
+                const uint32_t parent = parents_[i];
+
+                if (parent == INVALID_INDEX)
+                {
+                    world_matrices_[i]        = local_matrices_[i];
+                    world_normal_matrices_[i] = local_normal_matrices_[i];
+                }
+                else
+                {
+                    world_matrices_[i]        = world_matrices_[parent] * local_matrices_[i];
+                    world_normal_matrices_[i] = world_normal_matrices_[parent] * local_normal_matrices_[i];
+                }
+
+                callback(entities_[i], world_matrices_[i], world_normal_matrices_[i]);
+            }
+
+            propagated_count += walked_end - index;
+        }
+
+        return propagated_count;
+    }
+
+    flecs::entity KitSceneHierarchy::GetParent(const flecs::entity entity) const
+    {
+        const auto it = indices_.find(entity.id());
+        if (it == indices_.end() || parents_[it->second] == INVALID_INDEX)
+        {
+            return flecs::entity();
+        }
+
+        return entities_[parents_[it->second]];
+    }
+
+    uint32_t KitSceneHierarchy::AddRoot(const flecs::entity entity)
+    {
+        const uint32_t index = static_cast<uint32_t>(entities_.size());
+
+        entities_.push_back(entity);
+        parents_.push_back(INVALID_INDEX);
+        subtree_sizes_.push_back(1);
+        local_matrices_.emplace_back(1.f);
+        local_normal_matrices_.emplace_back(1.f);
+        world_matrices_.emplace_back(1.f);
+        world_normal_matrices_.emplace_back(1.f);
+
+        indices_[entity.id()] = index;
+        dirty_nodes_.push_back(entity.id());
+
+        return index;
+    }
+
+    void KitSceneHierarchy::AddToAncestorSizes(const uint32_t index, const int64_t delta)
+    {
+        for (uint32_t i = index; i != INVALID_INDEX; i = parents_[i])
+        {
+            subtree_sizes_[i] = static_cast<uint32_t>(subtree_sizes_[i] + delta);
+        }
+    }
+
+    void KitSceneHierarchy::Rotate(const uint32_t first, const uint32_t middle, const uint32_t last)
+    {
+        const auto rotate = [first, middle, last](auto& nodes)
+        {
+            std::rotate(nodes.begin() + first, nodes.begin() + middle, nodes.begin() + last);
+        };
+
+        rotate(entities_);
+        rotate(parents_);
+        rotate(subtree_sizes_);
+        rotate(local_matrices_);
+        rotate(local_normal_matrices_);
+        rotate(world_matrices_);
+        rotate(world_normal_matrices_);
+
+        // [first, middle) moved to the back of the range and [middle, last) to the front.
+        // Parents precede their children, so no node before first can point into the range.
+        for (uint32_t i = first; i < parents_.size(); i++)
+        {
+            uint32_t& parent = parents_[i];
+            if (parent == INVALID_INDEX || parent < first || parent >= last)
+            {
+                continue;
+            }
+
+            parent = parent < middle ? parent + (last - middle) : parent - (middle - first);
+        }
+
+        for (uint32_t i = first; i < last; i++)
+        {
+            indices_[entities_[i].id()] = i;
+        }
+    }
+} // Kitsune
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include <flecs.h>
+
+#include "Core/KitDefinitions.h"
+#include "Components/KitTransformComponent.h"
+
+namespace Kitsune
+{
+    // Parent/child links between scene entities, kept in depth first pre-order so a node's subtree is the contiguous
+    // range [index, index + subtree size) and parents always come before their children.
+    // Only the subtrees under dirty nodes are walked when propagating, static parts of the hierarchy cost nothing.
+    class KitSceneHierarchy
+    {
+    public:
+        static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+        using KitWorldMatrixCallback = std::function<void(flecs::entity, const glm::mat4&, const glm::mat4&)>;
+
+    private:
+        // Parallel arrays indexed in pre-order
+        std::vector<flecs::entity> entities_;
+        std::vector<uint32_t>      parents_;
+        std::vector<uint32_t>      subtree_sizes_;
+        std::vector<glm::mat4>     local_matrices_;
+        std::vector<glm::mat4>     local_normal_matrices_;
+        std::vector<glm::mat4>     world_matrices_;
+        std::vector<glm::mat4>     world_normal_matrices_;
+
+        std::unordered_map<flecs::entity_t, uint32_t> indices_;
+
+        // Entities rather than indices, reparenting moves nodes around before the next propagation
+        std::vector<flecs::entity_t> dirty_nodes_;
+        std::vector<uint32_t>        dirty_indices_;
+
+    public:
+        // Moves entity and its subtree under parent, a null parent makes it a root.
+        // Entities that are not in the hierarchy yet are added as roots first.
+        void SetParent(flecs::entity entity, flecs::entity parent);
+
+        // Removes entity and its subtree, returns the removed entities in pre-order
+        std::vector<flecs::entity> Remove(flecs::entity entity);
+
+        // Sets the matrices of the entity relative to its parent, its subtree gets propagated on the next call
+        void SetLocalMatrices(flecs::entity entity, const glm::mat4& model_matrix, const glm::mat4& normal_matrix);
+
+        // Recomputes world matrices under every dirty node and hands each one to the callback, returns how many
+        size_t Propagate(const KitWorldMatrixCallback& callback);
+
+        KIT_NODISCARD bool Contains(const flecs::entity entity) const { return indices_.contains(entity.id()); }
+        KIT_NODISCARD flecs::entity GetParent(flecs::entity entity) const;
+        KIT_NODISCARD size_t GetNodeCount() const { return entities_.size(); }
+
+    private:
+        uint32_t AddRoot(flecs::entity entity);
+        void AddToAncestorSizes(uint32_t index, int64_t delta);
+
+        // std::rotate on every array, keeping parent indices and the index map in sync
+        void Rotate(uint32_t first, uint32_t middle, uint32_t last);
+    };
+} // Kitsune
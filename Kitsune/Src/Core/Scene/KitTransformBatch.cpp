@@ -0,0 +1,327 @@
+#include "KitTransformBatch.h"
+
+#include <cmath>
+#include <cstdint>
+
+#if defined(__AVX2__)
+#define KIT_TRANSFORM_BATCH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KIT_TRANSFORM_BATCH_SSE
+#include <emmintrin.h>
+#endif
+
+namespace Kitsune
+{
+    namespace
+    {
+        struct KitTransformStreams
+        {
+            const float* translation[3];
+            const float* rotation[3];
+            const float* scale[3];
+        };
+
+        // Lane types share one kernel, each provides arithmetic, Less/Select masks, Truncate and the matrix store
+
+        struct KitFloat1
+        {
+            using Mask = bool;
+            static constexpr size_t WIDTH = 1;
+
+            float value;
+
+            KitFloat1(const float v) : value(v) {}
+
+            static KitFloat1 Load(const float* data) { return *data; }
+        };
+
+        inline KitFloat1 operator+(const KitFloat1 a, const KitFloat1 b) { return a.value + b.value; }
+        inline KitFloat1 operator-(const KitFloat1 a, const KitFloat1 b) { return a.value - b.value; }
+        inline KitFloat1 operator*(const KitFloat1 a, const KitFloat1 b) { return a.value * b.value; }
+        inline KitFloat1 operator/(const KitFloat1 a, const KitFloat1 b) { return a.value / b.value; }
+
+        inline bool Less(const KitFloat1 a, const KitFloat1 b) { return a.value < b.value; }
+        inline KitFloat1 Select(const bool mask, const KitFloat1 a, const KitFloat1 b) { return mask ? a : b; }
+        inline KitFloat1 Truncate(const KitFloat1 a) { return static_cast<float>(static_cast<int32_t>(a.value)); }
+        inline KitFloat1 Abs(const KitFloat1 a) { return a.value < 0.f ? -a.value : a.value; }
+
+        // columns[c][r] holds row r of column c
+        inline void StoreMatrices(const KitFloat1 (&columns)[4][4], glm::mat4* matrices)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                matrices[0][c] = glm::vec4(columns[c][0].value, columns[c][1].value, columns[c][2].value, columns[c][3].value);
+            }
+        }
+
+#if defined(KIT_TRANSFORM_BATCH_SSE) || defined(KIT_TRANSFORM_BATCH_AVX2)
+        // Writes column c of four matrices from the four row vectors of that column
+        inline void StoreColumn(__m128 row0, __m128 row1, __m128 row2, __m128 row3, glm::mat4* matrices, const int c)
+        {
+            _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+            _mm_storeu_ps(&matrices[0][c].x, row0);
+            _mm_storeu_ps(&matrices[1][c].x, row1);
+            _mm_storeu_ps(&matrices[2][c].x, row2);
+            _mm_storeu_ps(&matrices[3][c].x, row3);
+        }
+#endif
+
+#if defined(KIT_TRANSFORM_BATCH_SSE)
+        struct KitFloat4
+        {
+            using Mask = __m128;
+            static constexpr size_t WIDTH = 4;
+
+            __m128 value;
+
+            KitFloat4(const __m128 v) : value(v) {}
+            KitFloat4(const float v) : value(_mm_set1_ps(v)) {}
+
+            static KitFloat4 Load(const float* data) { return _mm_loadu_ps(data); }
+        };
+
+        inline KitFloat4 operator+(const KitFloat4 a, const KitFloat4 b) { return _mm_add_ps(a.value, b.value); }
+        inline KitFloat4 operator-(const KitFloat4 a, const KitFloat4 b) { return _mm_sub_ps(a.value, b.value); }
+        inline KitFloat4 operator*(const KitFloat4 a, const KitFloat4 b) { return _mm_mul_ps(a.value, b.value); }
+        inline KitFloat4 operator/(const KitFloat4 a, const KitFloat4 b) { return _mm_div_ps(a.value, b.value); }
+
+        inline __m128 Less(const KitFloat4 a, const KitFloat4 b) { return _mm_cmplt_ps(a.value, b.value); }
+
+        inline KitFloat4 Select(const __m128 mask, const KitFloat4 a, const KitFloat4 b)
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a.value), _mm_andnot_ps(mask, b.value));
+        }
+
+        inline KitFloat4 Truncate(const KitFloat4 a) { return _mm_cvtepi32_ps(_mm_cvttps_epi32(a.value)); }
+        inline KitFloat4 Abs(const KitFloat4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a.value); }
+
+        inline void StoreMatrices(const KitFloat4 (&columns)[4][4], glm::mat4* matrices)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                StoreColumn(columns[c][0].value, columns[c][1].value, columns[c][2].value, columns[c][3].value, matrices, c);
+            }
+        }
+
+        using KitFloatWide = KitFloat4;
+#elif defined(KIT_TRANSFORM_BATCH_AVX2)
+        struct KitFloat8
+        {
+            using Mask = __m256;
+            static constexpr size_t WIDTH = 8;
+
+            __m256 value;
+
+            KitFloat8(const __m256 v) : value(v) {}
+            KitFloat8(const float v) : value(_mm256_set1_ps(v)) {}
+
+            static KitFloat8 Load(const float* data) { return _mm256_loadu_ps(data); }
+        };
+
+        inline KitFloat8 operator+(const KitFloat8 a, const KitFloat8 b) { return _mm256_add_ps(a.value, b.value); }
+        inline KitFloat8 operator-(const KitFloat8 a, const KitFloat8 b) { return _mm256_sub_ps(a.value, b.value); }
+        inline KitFloat8 operator*(const KitFloat8 a, const KitFloat8 b) { return _mm256_mul_ps(a.value, b.value); }
+        inline KitFloat8 operator/(const KitFloat8 a, const KitFloat8 b) { return _mm256_div_ps(a.value, b.value); }
+
+        inline __m256 Less(const KitFloat8 a, const KitFloat8 b) { return _mm256_cmp_ps(a.value, b.value, _CMP_LT_OQ); }
+
+        inline KitFloat8 Select(const __m256 mask, const KitFloat8 a, const KitFloat8 b)
+        {
+            return _mm256_blendv_ps(b.value, a.value, mask);
+        }
+
+        inline KitFloat8 Truncate(const KitFloat8 a) { return _mm256_cvtepi32_ps(_mm256_cvttps_epi32(a.value)); }
+        inline KitFloat8 Abs(const KitFloat8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a.value); }
+
+        inline void StoreMatrices(const KitFloat8 (&columns)[4][4], glm::mat4* matrices)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                const __m256 row0 = columns[c][0].value;
+                const __m256 row1 = columns[c][1].value;
+                const __m256 row2 = columns[c][2].value;
+                const __m256 row3 = columns[c][3].value;
+
+                StoreColumn(
+                    _mm256_castps256_ps128(row0),
+                    _mm256_castps256_ps128(row1),
+                    _mm256_castps256_ps128(row2),
+                    _mm256_castps256_ps128(row3),
+                    matrices,
+                    c);
+
+                StoreColumn(
+                    _mm256_extractf128_ps(row0, 1),
+                    _mm256_extractf128_ps(row1, 1),
+                    _mm256_extractf128_ps(row2, 1),
+                    _mm256_extractf128_ps(row3, 1),
+                    matrices + 4,
+                    c);
+            }
+        }
+
+        using KitFloatWide = KitFloat8;
+#else
+        using KitFloatWide = KitFloat1;
+#endif
+
+        // Cephes style sincos. The angle is reduced by quarter turns into [-pi/4, pi/4], where two short polynomials
+        // are accurate to float precision, then sin and cos are swapped and negated depending on the quarter.
+        template<typename V>
+        void SinCos(const V angle, V& sin, V& cos)
+        {
+            const V x = Abs(angle);
+
+            const V quarter   = Truncate(x * V(0.63661977236f) + V(0.5f));
+            const V remainder = ((x - quarter * V(1.5703125f)) - quarter * V(4.837512969970703125e-4f))
+                                - quarter * V(7.54978995489188216e-8f);
+            const V quadrant  = quarter - V(4.f) * Truncate(quarter * V(0.25f));
+
+            const V z     = remainder * remainder;
+            const V sin_r = ((V(-1.9515295891e-4f) * z + V(8.3321608736e-3f)) * z + V(-1.6666654611e-1f)) * z * remainder
+                            + remainder;
+            const V cos_r = ((V(2.443315711809948e-5f) * z + V(-1.388731625493765e-3f)) * z + V(4.166664568298827e-2f)) * z * z
+                            - V(0.5f) * z + V(1.f);
+
+            // Odd quadrants swap sin and cos
+            const typename V::Mask is_swapped = Less(V(0.5f), quadrant - V(2.f) * Truncate(quadrant * V(0.5f)));
+
+            sin = Select(is_swapped, cos_r, sin_r);
+            cos = Select(is_swapped, sin_r, cos_r);
+
+            // sin is negative in quadrants 2 and 3 and mirrored for negative angles, cos is negative in quadrants 1 and 2
+            sin = Select(Less(V(1.5f), quadrant), V(0.f) - sin, sin);
+            sin = Select(Less(angle, V(0.f)), V(0.f) - sin, sin);
+            cos = Select(Less(Abs(quadrant - V(1.5f)), V(1.f)), V(0.f) - cos, cos);
+        }
+
+        // One lane at a time the branchy reduction above is slower than the C library
+        template<>
+        void SinCos<KitFloat1>(const KitFloat1 angle, KitFloat1& sin, KitFloat1& cos)
+        {
+            sin = std::sin(angle.value);
+            cos = std::cos(angle.value);
+        }
+
+        template<typename V>
+        void ComputeLanes(
+            const KitTransformStreams& streams,
+            const size_t               first,
+            glm::mat4*                 model_matrices,
+            glm::mat4*                 normal_matrices)
+        {
+            V s1(0.f), c1(0.f), s2(0.f), c2(0.f), s3(0.f), c3(0.f);
+            SinCos(V::Load(streams.rotation[1] + first), s1, c1);
+            SinCos(V::Load(streams.rotation[0] + first), s2, c2);
+            SinCos(V::Load(streams.rotation[2] + first), s3, c3);
+
+            // Closed form of Ry * Rx * Rz, the rotation order of KitTransform::ToMatrix()
+            const V rotation[3][3] = {
+                {c1 * c3 + s1 * s2 * s3, c2 * s3, c1 * s2 * s3 - c3 * s1},
+                {c3 * s1 * s2 - c1 * s3, c2 * c3, c1 * c3 * s2 + s1 * s3},
+                {c2 * s1, V(0.f) - s2, c1 * c2}};
+
+            const V scale[3] = {
+                V::Load(streams.scale[0] + first),
+                V::Load(streams.scale[1] + first),
+                V::Load(streams.scale[2] + first)};
+
+            const V zero(0.f);
+            const V one(1.f);
+
+            // The rotation is orthonormal so the inverse transpose of R * S is R * S^-1
+            V model[4][4] = {
+                {rotation[0][0] * scale[0], rotation[0][1] * scale[0], rotation[0][2] * scale[0], zero},
+                {rotation[1][0] * scale[1], rotation[1][1] * scale[1], rotation[1][2] * scale[1], zero},
+                {rotation[2][0] * scale[2], rotation[2][1] * scale[2], rotation[2][2] * scale[2], zero},
+                {
+                    V::Load(streams.translation[0] + first),
+                    V::Load(streams.translation[1] + first),
+                    V::Load(streams.translation[2] + first),
+                    one
+                }};
+
+            StoreMatrices(model, model_matrices + first);
+
+            const V inverse_scale[3] = {one / scale[0], one / scale[1], one / scale[2]};
+
+            V normal[4][4] = {
+                {rotation[0][0] * inverse_scale[0], rotation[0][1] * inverse_scale[0], rotation[0][2] * inverse_scale[0], zero},
+                {rotation[1][0] * inverse_scale[1], rotation[1][1] * inverse_scale[1], rotation[1][2] * inverse_scale[1], zero},
+                {rotation[2][0] * inverse_scale[2], rotation[2][1] * inverse_scale[2], rotation[2][2] * inverse_scale[2], zero},
+                {zero, zero, zero, one}};
+
+            StoreMatrices(normal, normal_matrices + first);
+        }
+    }
+
+    void KitTransformBatch::Reserve(const size_t count)
+    {
+        for (std::vector<float>* stream : {&translation_x_, &translation_y_, &translation_z_,
+                                           &rotation_x_, &rotation_y_, &rotation_z_,
+                                           &scale_x_, &scale_y_, &scale_z_})
+        {
+            stream->reserve(count);
+        }
+    }
+
+    void KitTransformBatch::Clear()
+    {
+        for (std::vector<float>* stream : {&translation_x_, &translation_y_, &translation_z_,
+                                           &rotation_x_, &rotation_y_, &rotation_z_,
+                                           &scale_x_, &scale_y_, &scale_z_})
+        {
+            stream->clear();
+        }
+    }
+
+    size_t KitTransformBatch::Add(const KitTransform& transform)
+    {
+        translation_x_.push_back(transform.translation.x);
+        translation_y_.push_back(transform.translation.y);
+        translation_z_.push_back(transform.translation.z);
+        rotation_x_.push_back(transform.rotation.x);
+        rotation_y_.push_back(transform.rotation.y);
+        rotation_z_.push_back(transform.rotation.z);
+        scale_x_.push_back(transform.scale.x);
+        scale_y_.push_back(transform.scale.y);
+        scale_z_.push_back(transform.scale.z);
+
+        return translation_x_.size() - 1;
+    }
+
+    void KitTransformBatch::Compute(glm::mat4* model_matrices, glm::mat4* normal_matrices) const
+    {
+        const KitTransformStreams streams{
+            {translation_x_.data(), translation_y_.data(), translation_z_.data()},
+            {rotation_x_.data(), rotation_y_.data(), rotation_z_.data()},
+            {scale_x_.data(), scale_y_.data(), scale_z_.data()}};
+
+        const size_t count = GetCount();
+        size_t       index = 0;
+
+        for (; index + KitFloatWide::WIDTH <= count; index += KitFloatWide::WIDTH)
+        {
+            ComputeLanes<KitFloatWide>(streams, index, model_matrices, normal_matrices);
+        }
+
+        // Tail shorter than a full register
+        for (; index < count; index++)
+        {
+            ComputeLanes<KitFloat1>(streams, index, model_matrices, normal_matrices);
+        }
+    }
+
+    const char* KitTransformBatch::GetInstructionSet()
+    {
+#if defined(KIT_TRANSFORM_BATCH_AVX2)
+        return "AVX2";
+#elif defined(KIT_TRANSFORM_BATCH_SSE)
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+} // Kitsune
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+
+#include "Core/KitDefinitions.h"
+#include "Components/KitTransformComponent.h"
+
+namespace Kitsune
+{
+    // Structure of arrays copy of many KitTransforms, turned into model and normal matrices in one pass.
+    // The kernel runs 8 transforms at a time with AVX2, 4 with SSE and falls back to scalar code elsewhere.
+    // Rotations use the closed form of Ry * Rx * Rz, results match KitTransform::ToMatrix() to float precision.
+    class KitTransformBatch
+    {
+        std::vector<float> translation_x_;
+        std::vector<float> translation_y_;
+        std::vector<float> translation_z_;
+        std::vector<float> rotation_x_;
+        std::vector<float> rotation_y_;
+        std::vector<float> rotation_z_;
+        std::vector<float> scale_x_;
+        std::vector<float> scale_y_;
+        std::vector<float> scale_z_;
+
+    public:
+        void Reserve(size_t count);
+        void Clear();
+
+        // Returns the index the matrices of this transform are written at
+        size_t Add(const KitTransform& transform);
+
+        // Both arrays must hold GetCount() matrices
+        void Compute(glm::mat4* model_matrices, glm::mat4* normal_matrices) const;
+
+        KIT_NODISCARD size_t GetCount() const { return translation_x_.size(); }
+
+        // Name of the instruction set Compute() was built for
+        static const char* GetInstructionSet();
+    };
+} // Kitsune
@@ -0,0 +1,249 @@
+#include "KitMeshBinaryCache.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+#include "Core/KitLogs.h"
+#include "Core/KitUtil.h"
+
+namespace Kitsune
+{
+    namespace
+    {
+        constexpr uint64_t BLOB_ALIGNMENT = 16;
+
+        // Numbers the temporary files of concurrent writes
+        std::atomic<uint32_t> temp_file_counter{0};
+
+        uint64_t AlignOffset(const uint64_t offset)
+        {
+            return (offset + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+        }
+
+        bool IsRangeInFile(const uint64_t offset, const uint64_t size, const size_t file_size)
+        {
+            return offset <= file_size && size <= file_size - offset;
+        }
+    }
+
+    KitMeshBinaryCache::KitMeshBinaryCache(std::filesystem::path cache_directory) :
+        cache_directory_(std::move(cache_directory))
+    {
+    }
+
+    std::optional<KitMeshSourceInfo> KitMeshBinaryCache::ReadSourceInfo(const std::string& source_path)
+    {
+        std::error_code error;
+
+        const auto mtime = std::filesystem::last_write_time(source_path, error);
+        if (error)
+        {
+            return std::nullopt;
+        }
+
+        const std::unique_ptr<KitMappedFile> source = KitMappedFile::Open(source_path);
+        if (source == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        KitMeshSourceInfo source_info{};
+        source_info.hash  = KitUtil::HashBytes(source->GetData(), source->GetSize());
+        source_info.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+        source_info.size  = source->GetSize();
+
+        return source_info;
+    }
+
+    std::filesystem::path KitMeshBinaryCache::GetCachePath(const std::string& source_path) const
+    {
+        const std::string stem = std::filesystem::path(source_path).stem().string();
+        const uint64_t    hash = KitUtil::HashBytes(source_path.data(), source_path.size());
+
+        return cache_directory_ / fmt::format("{}_{:016x}.kmesh", stem, hash);
+    }
+
+    std::optional<KitMappedMeshes> KitMeshBinaryCache::Load(const std::string& source_path, const KitMeshSourceInfo& source_info) const
+    {
+        std::unique_ptr<KitMappedFile> mapping = KitMappedFile::Open(GetCachePath(source_path).string());
+        if (mapping == nullptr || mapping->GetSize() < sizeof(KitMeshCacheHeader))
+        {
+            return std::nullopt;
+        }
+
+        const uint8_t* data      = mapping->GetData();
+        const size_t   file_size = mapping->GetSize();
+
+        const auto* header = reinterpret_cast<const KitMeshCacheHeader*>(data);
+        if (header->magic != MAGIC || header->version != VERSION)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_INFO, "Mesh cache for {} is from an older format, rebuilding", source_path);
+            return std::nullopt;
+        }
+
+        if (header->source_hash != source_info.hash ||
+            header->source_mtime != source_info.mtime ||
+            header->source_size != source_info.size)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_INFO, "Mesh cache for {} is stale, rebuilding", source_path);
+            return std::nullopt;
+        }
+
+        const uint64_t entries_size = static_cast<uint64_t>(header->mesh_count) * sizeof(KitMeshCacheEntry);
+        if (!IsRangeInFile(sizeof(KitMeshCacheHeader), entries_size, file_size))
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Mesh cache for {} is truncated", source_path);
+            return std::nullopt;
+        }
+
+        const auto* entries = reinterpret_cast<const KitMeshCacheEntry*>(data + sizeof(KitMeshCacheHeader));
+
+        KitMappedMeshes mapped_meshes{};
+        mapped_meshes.meshes.reserve(header->mesh_count);
+
+        for (uint32_t i = 0; i < header->mesh_count; i++)
+        {
+            const KitMeshCacheEntry& entry  = entries[i];
+            const auto               layout = static_cast<KitVertexLayout>(entry.layout);
+
+            if ((layout != KitVertexLayout::STANDARD && layout != KitVertexLayout::PACKED) ||
+                entry.vertex_stride != GetVertexStride(layout))
+            {
+                KIT_LOG(LOG_IO, KitLogLevel::LOG_INFO, "Mesh cache for {} has an outdated vertex layout, rebuilding", source_path);
+                return std::nullopt;
+            }
+
+            const uint64_t vertices_size = static_cast<uint64_t>(entry.vertex_count) * entry.vertex_stride;
+            const uint64_t indices_size  = static_cast<uint64_t>(entry.index_count) * sizeof(uint32_t);
+
+            if (!IsRangeInFile(entry.vertex_offset, vertices_size, file_size) ||
+                !IsRangeInFile(entry.index_offset, indices_size, file_size))
+            {
+                KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Mesh cache for {} is truncated", source_path);
+                return std::nullopt;
+            }
+
+            KitMeshView& mesh    = mapped_meshes.meshes.emplace_back();
+            mesh.layout          = layout;
+            mesh.vertices        = std::span(reinterpret_cast<const std::byte*>(data + entry.vertex_offset), vertices_size);
+            mesh.vertex_count    = entry.vertex_count;
+            mesh.indices         = std::span(reinterpret_cast<const uint32_t*>(data + entry.index_offset), entry.index_count);
+            mesh.position_min    = glm::vec3(entry.position_min[0], entry.position_min[1], entry.position_min[2]);
+            mesh.position_extent = glm::vec3(entry.position_extent[0], entry.position_extent[1], entry.position_extent[2]);
+            mesh.bounds.aabb.min = glm::vec3(entry.bounds_min[0], entry.bounds_min[1], entry.bounds_min[2]);
+            mesh.bounds.aabb.max = glm::vec3(entry.bounds_max[0], entry.bounds_max[1], entry.bounds_max[2]);
+
+            mesh.bounds.sphere.center = glm::vec3(entry.sphere_center[0], entry.sphere_center[1], entry.sphere_center[2]);
+            mesh.bounds.sphere.radius = entry.sphere_radius;
+        }
+
+        mapped_meshes.mapping = std::move(mapping);
+
+        return mapped_meshes;
+    }
+
+    bool KitMeshBinaryCache::Write(
+        const std::string&              source_path,
+        const KitMeshSourceInfo&        source_info,
+        const std::vector<KitMeshView>& meshes) const
+    {
+        std::error_code error;
+        std::filesystem::create_directories(cache_directory_, error);
+        if (error)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Could not create mesh cache directory: {}", error.message());
+            return false;
+        }
+
+        KitMeshCacheHeader header{};
+        header.magic        = MAGIC;
+        header.version      = VERSION;
+        header.source_hash  = source_info.hash;
+        header.source_mtime = source_info.mtime;
+        header.source_size  = source_info.size;
+        header.mesh_count   = static_cast<uint32_t>(meshes.size());
+
+        // Lay out the blobs first so the entry table can be written up front
+        std::vector<KitMeshCacheEntry> entries(meshes.size());
+        uint64_t offset = sizeof(KitMeshCacheHeader) + entries.size() * sizeof(KitMeshCacheEntry);
+
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            entries[i].layout        = static_cast<uint32_t>(meshes[i].layout);
+            entries[i].vertex_stride = GetVertexStride(meshes[i].layout);
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                entries[i].position_min[axis]    = meshes[i].position_min[axis];
+                entries[i].position_extent[axis] = meshes[i].position_extent[axis];
+                entries[i].bounds_min[axis]      = meshes[i].bounds.aabb.min[axis];
+                entries[i].bounds_max[axis]      = meshes[i].bounds.aabb.max[axis];
+                entries[i].sphere_center[axis]   = meshes[i].bounds.sphere.center[axis];
+            }
+
+            entries[i].sphere_radius = meshes[i].bounds.sphere.radius;
+
+            entries[i].vertex_count  = meshes[i].vertex_count;
+            entries[i].vertex_offset = AlignOffset(offset);
+            offset                   = entries[i].vertex_offset + meshes[i].vertices.size();
+
+            entries[i].index_count  = static_cast<uint32_t>(meshes[i].indices.size());
+            entries[i].index_offset = AlignOffset(offset);
+            offset                  = entries[i].index_offset + meshes[i].indices.size() * sizeof(uint32_t);
+        }
+
+        // Write to a temporary file and rename it so a crash never leaves a half written cache behind
+        const std::filesystem::path cache_path = GetCachePath(source_path);
+        std::filesystem::path       temp_path  = cache_path;
+
+        // Async loads of the same source write concurrently, each one into its own file. The last rename wins with a
+        // complete file.
+        const size_t thread_hash = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        temp_path += fmt::format(".{:x}_{}.tmp", thread_hash, temp_file_counter.fetch_add(1, std::memory_order_relaxed));
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file.is_open())
+            {
+                KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Could not open mesh cache file: {}", temp_path.string());
+                return false;
+            }
+
+            constexpr char padding[BLOB_ALIGNMENT] = {};
+            const auto write_padded = [&file, &padding](const void* blob, const uint64_t blob_offset, const uint64_t blob_size)
+            {
+                const uint64_t position = static_cast<uint64_t>(file.tellp());
+                file.write(padding, static_cast<std::streamsize>(blob_offset - position));
+                file.write(static_cast<const char*>(blob), static_cast<std::streamsize>(blob_size));
+            };
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(KitMeshCacheEntry)));
+
+            for (size_t i = 0; i < meshes.size(); i++)
+            {
+                write_padded(meshes[i].vertices.data(), entries[i].vertex_offset, meshes[i].vertices.size());
+                write_padded(meshes[i].indices.data(), entries[i].index_offset, meshes[i].indices.size() * sizeof(uint32_t));
+            }
+
+            if (!file.good())
+            {
+                KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Failed writing mesh cache file: {}", temp_path.string());
+                file.close();
+                std::filesystem::remove(temp_path, error);
+                return false;
+            }
+        }
+
+        std::filesystem::rename(temp_path, cache_path, error);
+        if (error)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Could not move mesh cache file into place: {}", error.message());
+            std::filesystem::remove(temp_path, error);
+            return false;
+        }
+
+        return true;
+    }
+} // Kitsune
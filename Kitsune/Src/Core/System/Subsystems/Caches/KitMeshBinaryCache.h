@@ -0,0 +1,81 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Core/KitMappedFile.h"
+#include "Graphics/KitModel.h"
+
+namespace Kitsune
+{
+    // Identifies the source asset a cache file was built from
+    struct KitMeshSourceInfo
+    {
+        uint64_t hash  = 0;
+        int64_t  mtime = 0;
+        uint64_t size  = 0;
+    };
+
+    // Meshes read from a cache file, the views point straight into the mapping
+    struct KitMappedMeshes
+    {
+        std::unique_ptr<KitMappedFile> mapping;
+        std::vector<KitMeshView>       meshes;
+    };
+
+    // Kitsune native mesh format, lets warm starts skip Assimp entirely
+    //
+    // Layout: KitMeshCacheHeader, mesh_count KitMeshCacheEntry, then the vertex and index blobs.
+    // Blobs are 16 byte aligned so they can be read in place from the mapping.
+    class KitMeshBinaryCache final
+    {
+    public:
+        static constexpr uint32_t MAGIC   = 0x48534D4B; // "KMSH"
+        static constexpr uint32_t VERSION = 4; // 4: per mesh bounds
+
+        struct KitMeshCacheHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint64_t source_hash;
+            int64_t  source_mtime;
+            uint64_t source_size;
+            uint32_t mesh_count;
+            uint32_t reserved;
+        };
+
+        struct KitMeshCacheEntry
+        {
+            uint64_t vertex_offset;
+            uint64_t index_offset;
+            uint32_t vertex_count;
+            uint32_t index_count;
+            uint32_t layout;
+            uint32_t vertex_stride;
+            float    position_min[3];
+            float    position_extent[3];
+            float    bounds_min[3];
+            float    bounds_max[3];
+            float    sphere_center[3];
+            float    sphere_radius;
+        };
+
+    private:
+        std::filesystem::path cache_directory_;
+
+    public:
+        explicit KitMeshBinaryCache(std::filesystem::path cache_directory = "Cache/Meshes");
+
+        // Hashes the whole source file, returns nullopt if it can not be read
+        static std::optional<KitMeshSourceInfo> ReadSourceInfo(const std::string& source_path);
+
+        // Returns nullopt if there is no cache file or it is stale
+        std::optional<KitMappedMeshes> Load(const std::string& source_path, const KitMeshSourceInfo& source_info) const;
+        bool Write(const std::string& source_path, const KitMeshSourceInfo& source_info, const std::vector<KitMeshView>& meshes) const;
+
+        KIT_NODISCARD std::filesystem::path GetCachePath(const std::string& source_path) const;
+    };
+} // Kitsune
@@ -1,9 +1,17 @@
 #include "KitModelResourceCache.h"
 
+#include <chrono>
+
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
+#include "Core/KitLogs.h"
+#include "Core/System/Subsystems/KitResourceWatcherSystem.h"
+#include "Graphics/KitMeshOptimizer.h"
+#include "Graphics/KitUploadManager.h"
+#include "Graphics/KitVertexQuantizer.h"
+
 namespace Kitsune
 {
     KitMeshData ProcessMesh(aiMesh *mesh, const aiScene *scene)
@@ -63,41 +71,306 @@ namespace Kitsune
             }
         }
 
-        return KitMeshData(vertices, indices);
+        // Welding and reordering later keep every position, the bounds stay valid
+        const KitMeshBounds bounds = KitMeshBounds::FromVertices(std::span<const KitVertex>(vertices));
+
+        return KitMeshData(vertices, indices, bounds);
     }
 
-    void KitModelResourceCache::ProcessNode(aiNode *node, const aiScene *scene, KitModel* model)
+    void ProcessNode(aiNode *node, const aiScene *scene, std::vector<KitMeshData>& meshes)
     {
         // process all the node's meshes (if any)
         for(unsigned int i = 0; i < node->mNumMeshes; i++)
         {
             aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-            model->AddMesh(device_, ProcessMesh(mesh, scene));
+            meshes.push_back(ProcessMesh(mesh, scene));
         }
 
         // then do the same for each of its children
         for(unsigned int i = 0; i < node->mNumChildren; i++)
         {
-            ProcessNode(node->mChildren[i], scene, model);
+            ProcessNode(node->mChildren[i], scene, meshes);
         }
     }
 
-    bool KitModelResourceCache::LoadFromFile(const std::string& name, const std::string& file_path)
+    // Safe to run on any thread, touches no GPU state
+    KitModelResourceCache::KitImportResult KitModelResourceCache::ImportMeshes(
+        const KitMeshBinaryCache& binary_cache,
+        const std::string&        file_path)
     {
+        const std::optional<KitMeshSourceInfo> source_info = KitMeshBinaryCache::ReadSourceInfo(file_path);
+
+        if (source_info.has_value())
+        {
+            if (std::optional<KitMappedMeshes> mapped_meshes = binary_cache.Load(file_path, *source_info))
+            {
+                KitImportedModel imported_model{};
+                imported_model.meshes        = mapped_meshes->meshes;
+                imported_model.mapped_meshes = std::move(*mapped_meshes);
+
+                return imported_model;
+            }
+        }
+
         Assimp::Importer import;
         const aiScene *scene = import.ReadFile(file_path, aiProcess_Triangulate);
 
         if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
         {
+            return std::nullopt;
+        }
+
+        KitImportedModel imported_model{};
+        ProcessNode(scene->mRootNode, scene, imported_model.owned_meshes);
+
+        // Optimized and packed before the cache write so warm starts get both for free
+        imported_model.owned_packed_meshes.reserve(imported_model.owned_meshes.size());
+        imported_model.meshes.reserve(imported_model.owned_meshes.size());
+
+        for (size_t i = 0; i < imported_model.owned_meshes.size(); i++)
+        {
+            KitMeshData& mesh = imported_model.owned_meshes[i];
+
+            const KitMeshOptimizeStats stats = KitMeshOptimizer::Optimize(mesh);
+
+            KIT_LOG(
+                LOG_ENGINE,
+                KitLogLevel::LOG_INFO,
+                "Optimized mesh {} of {}: vertices {} -> {}, ACMR {:.3f} -> {:.3f}",
+                i,
+                file_path,
+                stats.vertex_count_before,
+                stats.vertex_count_after,
+                stats.acmr_before,
+                stats.acmr_after);
+
+            if (KitVertexQuantizer::ChooseLayout(mesh) == KitVertexLayout::PACKED)
+            {
+                imported_model.meshes.emplace_back(imported_model.owned_packed_meshes.emplace_back(KitVertexQuantizer::Pack(mesh)));
+            }
+            else
+            {
+                imported_model.meshes.emplace_back(mesh);
+            }
+        }
+
+        if (source_info.has_value() && binary_cache.Write(file_path, *source_info, imported_model.meshes))
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_INFO, "Wrote mesh cache for {}", file_path);
+        }
+
+        return imported_model;
+    }
+
+    std::shared_ptr<KitModel> KitModelResourceCache::CreateModel(const std::vector<KitMeshView>& meshes) const
+    {
+        auto model = std::make_shared<KitModel>();
+
+        for (const KitMeshView& mesh : meshes)
+        {
+            model->AddMesh(device_, mesh);
+        }
+
+        return model;
+    }
+
+    bool KitModelResourceCache::LoadFromFile(const std::string& name, const std::string& file_path)
+    {
+        const KitResourceId id = KitResourceId::Intern(name);
+        const KitImportResult imported_model = ImportMeshes(binary_cache_, file_path);
+
+        if (!imported_model.has_value())
+        {
+            states_[id] = KitResourceState::FAILED;
+            return false;
+        }
+
+        Insert(id, CreateModel(imported_model->meshes));
+        states_.erase(id);
+        OnModelLoaded(id, file_path);
+
+        return true;
+    }
+
+    std::shared_future<bool> KitModelResourceCache::LoadFromFileAsync(const std::string& name, const std::string& file_path)
+    {
+        const KitResourceId id = KitResourceId::Intern(name);
+
+        for (const KitPendingModel& pending_model : pending_models_)
+        {
+            if (pending_model.id == id)
+            {
+                return pending_model.completion;
+            }
+        }
+
+        if (GetState(id) == KitResourceState::READY)
+        {
+            std::promise<bool> ready;
+            ready.set_value(true);
+            return ready.get_future().share();
+        }
+
+        file_paths_[id] = file_path;
+        states_[id]     = KitResourceState::PENDING;
+
+        return SubmitImport(id, file_path).completion;
+    }
+
+    bool KitModelResourceCache::Reload(const KitResourceId id)
+    {
+        const auto file_path = file_paths_.find(id);
+        if (file_path == file_paths_.end() || Find(id) == nullptr)
+        {
+            return false;
+        }
+
+        // The import in flight may already have read the previous save, it is imported again once it completes
+        for (KitPendingModel& pending_model : pending_models_)
+        {
+            if (pending_model.id == id)
+            {
+                pending_model.has_newer_source = true;
+                return true;
+            }
+        }
+
+        SubmitImport(id, file_path->second).is_reload = true;
+
+        return true;
+    }
+
+    KitModelResourceCache::KitPendingModel& KitModelResourceCache::SubmitImport(const KitResourceId id, const std::string& file_path)
+    {
+        KitPendingModel& pending_model = pending_models_.emplace_back();
+        pending_model.id           = id;
+        pending_model.import       = job_system_->Submit(
+            [binary_cache = binary_cache_, file_path]() { return ImportMeshes(binary_cache, file_path); });
+        pending_model.completion   = pending_model.promise.get_future().share();
+        pending_model.requested_at = std::chrono::steady_clock::now();
+
+        return pending_model;
+    }
+
+    bool KitModelResourceCache::CompletePendingModel(KitPendingModel& pending_model)
+    {
+        const KitImportResult imported_model = pending_model.import.get();
+
+        if (!imported_model.has_value())
+        {
+            KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_ERROR, "Fail to import model: {}", pending_model.id.GetName());
+
+            // A broken save keeps the model that is already loaded
+            if (!pending_model.is_reload)
+            {
+                states_[pending_model.id] = KitResourceState::FAILED;
+            }
+
+            pending_model.promise.set_value(false);
             return false;
         }
 
-        auto model = std::make_unique<KitModel>();
+        if (pending_model.is_reload)
+        {
+            // Evicted while reimporting, nobody is left to see the new version
+            if (const std::shared_ptr<KitModel> model = Find(pending_model.id))
+            {
+                // The old meshes go away with the temporary model, the arena holds their ranges until frames in flight are done
+                const std::shared_ptr<KitModel> reloaded_model = CreateModel(imported_model->meshes);
+                model->SwapMeshes(*reloaded_model);
+                RefreshFootprint(pending_model.id);
+
+                const std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - pending_model.requested_at;
+                KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_INFO, "Reloaded model {} in {:.1f} ms", pending_model.id.GetName(), latency.count());
+            }
 
-        ProcessNode(scene->mRootNode, scene, model.get());
+            pending_model.promise.set_value(true);
+            return true;
+        }
 
-        cache_[name] = std::move(model);
+        Insert(pending_model.id, CreateModel(imported_model->meshes));
+        states_.erase(pending_model.id);
+        OnModelLoaded(pending_model.id, file_paths_[pending_model.id]);
+        pending_model.promise.set_value(true);
 
         return true;
     }
-} // Kitsune
\ No newline at end of file
+
+    void KitModelResourceCache::OnModelLoaded(const KitResourceId id, const std::string& file_path)
+    {
+        file_paths_[id] = file_path;
+
+        if (watcher_ != nullptr)
+        {
+            watcher_->Watch(file_path, this, id);
+        }
+    }
+
+    void KitModelResourceCache::ResubmitReloads(const std::vector<KitResourceId>& ids)
+    {
+        for (const KitResourceId id : ids)
+        {
+            if (const auto file_path = file_paths_.find(id); file_path != file_paths_.end() && Find(id) != nullptr)
+            {
+                SubmitImport(id, file_path->second).is_reload = true;
+            }
+        }
+    }
+
+    void KitModelResourceCache::Update()
+    {
+        uint32_t                   upload_count = 0;
+        std::vector<KitResourceId> stale_ids;
+
+        std::erase_if(
+            pending_models_,
+            [this, &upload_count, &stale_ids](KitPendingModel& pending_model)
+            {
+                if (upload_count >= max_uploads_per_frame_ ||
+                    pending_model.import.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    return false;
+                }
+
+                upload_count++;
+                CompletePendingModel(pending_model);
+
+                if (pending_model.has_newer_source)
+                {
+                    stale_ids.push_back(pending_model.id);
+                }
+
+                return true;
+            });
+
+        // Submitted after the sweep, pending_models_ cannot grow while it is being erased from
+        ResubmitReloads(stale_ids);
+
+        KitResourceCache::Update();
+    }
+
+    void KitModelResourceCache::WaitForPendingLoads()
+    {
+        // Stale reloads are imported again until every model matches its latest save
+        while (!pending_models_.empty())
+        {
+            std::vector<KitResourceId> stale_ids;
+
+            for (KitPendingModel& pending_model : pending_models_)
+            {
+                CompletePendingModel(pending_model);
+
+                if (pending_model.has_newer_source)
+                {
+                    stale_ids.push_back(pending_model.id);
+                }
+            }
+
+            pending_models_.clear();
+            ResubmitReloads(stale_ids);
+        }
+
+        // Callers expect the models to be drawable right away
+        device_->GetUploadManager()->WaitIdle();
+    }
+} // Kitsune
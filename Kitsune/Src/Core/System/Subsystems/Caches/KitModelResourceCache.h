@@ -1,7 +1,15 @@
 #pragma once
+#include <chrono>
+#include <future>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
 #include <assimp/scene.h>
 
 
+#include "KitMeshBinaryCache.h"
+#include "Core/KitJobSystem.h"
 #include "Core/System/Subsystems/KitResourceCache.h"
 #include "Graphics/KitModel.h"
 
@@ -9,14 +17,77 @@ namespace Kitsune
 {
     class KitModelResourceCache final : public KitResourceCache<KitModel>
     {
-        void ProcessNode(aiNode* node, const aiScene* scene, KitModel* model);
+        struct KitImportedModel
+        {
+            // Filled when the source went through Assimp
+            std::vector<KitMeshData>       owned_meshes;
+            std::vector<KitPackedMeshData> owned_packed_meshes;
+
+            // Filled when the binary cache was hit
+            KitMappedMeshes mapped_meshes;
+
+            // Views into one of the above, in import order
+            std::vector<KitMeshView> meshes;
+        };
+
+        using KitImportResult = std::optional<KitImportedModel>;
+
+        struct KitPendingModel
+        {
+            KitResourceId                id;
+            std::future<KitImportResult> import;
+            std::promise<bool>           promise;
+            std::shared_future<bool>     completion;
+
+            // Reloads swap the meshes of the live model instead of inserting a new one
+            bool                                  is_reload = false;
+            std::chrono::steady_clock::time_point requested_at;
+
+            // Saved again while importing, the import may have read the older bytes
+            bool has_newer_source = false;
+        };
+
+        KitJobSystem*      job_system_ = nullptr;
+        KitMeshBinaryCache binary_cache_;
+
+        std::vector<KitPendingModel> pending_models_;
+
+        // Source of every loaded model, for reloads
+        std::unordered_map<KitResourceId, std::string> file_paths_;
+
+        // Caps the GPU uploads done in a single frame so big batches do not stall the frame loop
+        uint32_t max_uploads_per_frame_ = 4;
+
+        // Reads from the binary cache when it is up to date, otherwise imports and refreshes it
+        static KitImportResult ImportMeshes(const KitMeshBinaryCache& binary_cache, const std::string& file_path);
+
+        std::shared_ptr<KitModel> CreateModel(const std::vector<KitMeshView>& meshes) const;
+        KitPendingModel& SubmitImport(KitResourceId id, const std::string& file_path);
+        bool CompletePendingModel(KitPendingModel& pending_model);
+        void ResubmitReloads(const std::vector<KitResourceId>& ids);
+        void OnModelLoaded(KitResourceId id, const std::string& file_path);
 
     public:
-        explicit KitModelResourceCache(KitEngineDevice* device):
-            KitResourceCache<KitModel>(device)
+        explicit KitModelResourceCache(KitEngineDevice* device, KitJobSystem* job_system):
+            KitResourceCache<KitModel>(device),
+            job_system_(job_system)
         {
         }
 
         bool LoadFromFile(const std::string& name, const std::string& file_path) override;
+
+        // Parses on the job system, the GPU resources are created by Update() in a later frame
+        std::shared_future<bool> LoadFromFileAsync(const std::string& name, const std::string& file_path);
+
+        // Re-imports in the background, every holder of the model sees the new meshes once the swap happens in Update()
+        bool Reload(KitResourceId id) override;
+
+        void Update() override;
+
+        // Blocks until every async load has been parsed and uploaded
+        void WaitForPendingLoads();
+
+        void SetMaxUploadsPerFrame(const uint32_t max_uploads) { max_uploads_per_frame_ = max_uploads; }
+        KIT_NODISCARD size_t GetPendingLoadCount() const { return pending_models_.size(); }
     };
 } // Kitsune
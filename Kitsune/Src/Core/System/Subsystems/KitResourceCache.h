@@ -1,17 +1,59 @@
 #pragma once
 
+#include <concepts>
+#include <list>
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
+#include "Core/KitLogs.h"
+#include "Core/KitResourceId.h"
 #include "Graphics/KitEngineDevice.h"
+#include "Graphics/KitSwapChain.h"
 
 namespace Kitsune
 {
+    enum class KitResourceState
+    {
+        MISSING,
+        PENDING,
+        READY,
+        FAILED,
+    };
+
+    struct KitResourceFootprint
+    {
+        size_t cpu_bytes = 0;
+        size_t gpu_bytes = 0;
+    };
+
+    struct KitResourceCacheStats
+    {
+        uint64_t hits      = 0;
+        uint64_t misses    = 0;
+        uint64_t evictions = 0;
+
+        size_t cpu_bytes    = 0;
+        size_t gpu_bytes    = 0;
+        size_t budget_bytes = 0;
+        size_t entry_count  = 0;
+    };
+
+    // Resources can report what they hold, everything else is accounted as sizeof(T)
+    template<typename T>
+    concept ResourceFootprintConcept = requires(const T& resource)
+    {
+        { resource.GetMemoryFootprint() } -> std::same_as<KitResourceFootprint>;
+    };
+
+    class KitResourceWatcherSystem;
+
     class KitResourceCacheBase
     {
     protected:
-        KitEngineDevice* device_;
+        KitEngineDevice*          device_;
+        KitResourceWatcherSystem* watcher_ = nullptr;
 
     public:
         explicit KitResourceCacheBase(KitEngineDevice* device):
@@ -20,25 +62,214 @@ namespace Kitsune
         }
 
         virtual ~KitResourceCacheBase() = default;
+
+        // Called once per frame from the main thread
+        virtual void Update() {}
+
+        KIT_NODISCARD virtual KitResourceCacheStats GetStats() const { return {}; }
+
+        // Re-imports a resource from its source and swaps it in at a later frame boundary.
+        // Returns false when the cache does not hold the resource (anymore).
+        virtual bool Reload(const KitResourceId id) { return false; }
+
+        // Loads from now on register their source files with the watcher
+        void SetWatcher(KitResourceWatcherSystem* watcher) { watcher_ = watcher; }
     };
 
     template<typename T>
     class KitResourceCache : public KitResourceCacheBase
     {
+        struct KitCacheEntry
+        {
+            std::shared_ptr<T>                 resource;
+            KitResourceFootprint               footprint;
+            std::list<KitResourceId>::iterator lru_position;
+        };
+
+        struct KitRetiredResource
+        {
+            std::shared_ptr<T> resource;
+            uint64_t           frame;
+        };
+
+        std::unordered_map<KitResourceId, KitCacheEntry> cache_;
+
+        // Front is the most recently used
+        std::list<KitResourceId> lru_;
+
+        // Evicted resources are kept alive until no frame in flight can reference them
+        std::vector<KitRetiredResource> retired_;
+        uint64_t                        frame_index_ = 0;
+
+        KitResourceCacheStats stats_{};
+
     protected:
-        std::unordered_map<std::string, std::shared_ptr<T>> cache_;
+        // Only tracks resources that are not ready yet
+        std::unordered_map<KitResourceId, KitResourceState> states_;
+
+        void Insert(const KitResourceId id, std::shared_ptr<T> resource)
+        {
+            Remove(id);
+
+            KitCacheEntry& entry = cache_[id];
+            entry.resource       = std::move(resource);
+            entry.footprint      = GetFootprint(*entry.resource);
+            entry.lru_position   = lru_.insert(lru_.begin(), id);
+
+            stats_.cpu_bytes += entry.footprint.cpu_bytes;
+            stats_.gpu_bytes += entry.footprint.gpu_bytes;
+        }
+
+        // No stats or LRU update, for the cache's own bookkeeping
+        std::shared_ptr<T> Find(const KitResourceId id) const
+        {
+            const auto it = cache_.find(id);
+            return it != cache_.end() ? it->second.resource : nullptr;
+        }
+
+        // For resources whose content was replaced in place
+        void RefreshFootprint(const KitResourceId id)
+        {
+            const auto it = cache_.find(id);
+            if (it == cache_.end())
+            {
+                return;
+            }
+
+            stats_.cpu_bytes -= it->second.footprint.cpu_bytes;
+            stats_.gpu_bytes -= it->second.footprint.gpu_bytes;
+
+            it->second.footprint = GetFootprint(*it->second.resource);
+
+            stats_.cpu_bytes += it->second.footprint.cpu_bytes;
+            stats_.gpu_bytes += it->second.footprint.gpu_bytes;
+        }
 
     public:
+        static constexpr size_t DEFAULT_BUDGET_BYTES = 512ull * 1024 * 1024;
+
         explicit KitResourceCache(KitEngineDevice* device):
             KitResourceCacheBase(device)
         {
+            stats_.budget_bytes = DEFAULT_BUDGET_BYTES;
         }
 
         virtual bool LoadFromFile(const std::string& name, const std::string& file_path) = 0;
 
-        std::shared_ptr<T> Get(const std::string& name)
+        // Never inserts, a miss returns null. Accepts names too, but per frame callers should keep the id
+        // (or a "name"_rid literal) so no string is hashed.
+        std::shared_ptr<T> Get(const KitResourceId id)
+        {
+            const auto it = cache_.find(id);
+            if (it == cache_.end())
+            {
+                stats_.misses++;
+                return nullptr;
+            }
+
+            stats_.hits++;
+            lru_.splice(lru_.begin(), lru_, it->second.lru_position);
+
+            return it->second.resource;
+        }
+
+        KitResourceState GetState(const KitResourceId id) const
         {
-            return cache_[name];
+            if (cache_.contains(id))
+            {
+                return KitResourceState::READY;
+            }
+
+            if (const auto it = states_.find(id); it != states_.end())
+            {
+                return it->second;
+            }
+
+            return KitResourceState::MISSING;
+        }
+
+        void Update() override
+        {
+            frame_index_++;
+
+            EvictToBudget();
+
+            std::erase_if(
+                retired_,
+                [this](const KitRetiredResource& retired)
+                {
+                    return frame_index_ - retired.frame > KitSwapChain::MAX_FRAMES_IN_FLIGHT;
+                });
+        }
+
+        // Unreferenced resources are evicted least recently used first until the cache fits, 0 disables the budget
+        void SetBudget(const size_t budget_bytes) { stats_.budget_bytes = budget_bytes; }
+
+        KIT_NODISCARD KitResourceCacheStats GetStats() const override
+        {
+            KitResourceCacheStats stats = stats_;
+            stats.entry_count           = cache_.size();
+
+            return stats;
+        }
+
+    private:
+        static KitResourceFootprint GetFootprint(const T& resource)
+        {
+            if constexpr (ResourceFootprintConcept<T>)
+            {
+                return resource.GetMemoryFootprint();
+            }
+            else
+            {
+                return {sizeof(T), 0};
+            }
+        }
+
+        void Remove(const KitResourceId id)
+        {
+            const auto it = cache_.find(id);
+            if (it == cache_.end())
+            {
+                return;
+            }
+
+            stats_.cpu_bytes -= it->second.footprint.cpu_bytes;
+            stats_.gpu_bytes -= it->second.footprint.gpu_bytes;
+
+            lru_.erase(it->second.lru_position);
+            retired_.push_back({std::move(it->second.resource), frame_index_});
+            cache_.erase(it);
+        }
+
+        void EvictToBudget()
+        {
+            if (stats_.budget_bytes == 0)
+            {
+                return;
+            }
+
+            auto lru_it = lru_.end();
+            while (stats_.cpu_bytes + stats_.gpu_bytes > stats_.budget_bytes && lru_it != lru_.begin())
+            {
+                --lru_it;
+
+                // Someone still holds it, evicting would only drop our bookkeeping
+                const KitCacheEntry& entry = cache_.at(*lru_it);
+                if (entry.resource.use_count() > 1)
+                {
+                    continue;
+                }
+
+                const KitResourceId id = *lru_it;
+                lru_it = std::next(lru_it);
+
+                KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_INFO, "Evicting resource {} ({} bytes) to stay in budget",
+                        id.GetName(), entry.footprint.cpu_bytes + entry.footprint.gpu_bytes);
+
+                Remove(id);
+                stats_.evictions++;
+            }
         }
     };
 } // Kitsune
@@ -1,5 +1,9 @@
 #include "KitResourceSystem.h"
 
+#include <ranges>
+
+#include "Core/KitLogs.h"
+
 namespace Kitsune
 {
     bool KitResourceSystem::Init(KitEngineDevice* device)
@@ -8,8 +12,26 @@ namespace Kitsune
         return true;
     }
 
+    void KitResourceSystem::Update(const float dt)
+    {
+        for (auto& cache : resource_caches_ | std::views::values)
+        {
+            cache->Update();
+        }
+    }
+
     bool KitResourceSystem::End()
     {
+        // Numbers to size the cache budgets with
+        for (const auto& [type, cache] : resource_caches_)
+        {
+            const KitResourceCacheStats stats = cache->GetStats();
+            KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_INFO,
+                    "{}: {} hits, {} misses, {} evictions, {} entries using {} CPU / {} GPU bytes of a {} byte budget",
+                    type.name(), stats.hits, stats.misses, stats.evictions, stats.entry_count,
+                    stats.cpu_bytes, stats.gpu_bytes, stats.budget_bytes);
+        }
+
         return true;
     }
-} // Kitsune
\ No newline at end of file
+} // Kitsune
@@ -19,13 +19,14 @@ namespace Kitsune
 
     protected:
         bool Init(KitEngineDevice* device) override;
+        void Update(const float dt) override;
         bool End() override;
 
     public:
-        template <ResourceCacheConcept T>
-        void RegisterCache()
+        template <ResourceCacheConcept T, typename... Args>
+        void RegisterCache(Args&&... args)
         {
-            resource_caches_[typeid(T)] = std::make_unique<T>(device_);
+            resource_caches_[typeid(T)] = std::make_unique<T>(device_, std::forward<Args>(args)...);
         }
 
         template <ResourceCacheConcept T>
@@ -0,0 +1,159 @@
+#include "KitResourceWatcherSystem.h"
+
+#include <unordered_set>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include "KitResourceCache.h"
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    bool KitResourceWatcherSystem::Init(KitEngineDevice* device)
+    {
+#ifdef __linux__
+        inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotify_fd_ < 0)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "inotify is unavailable, resource hot reload is disabled");
+        }
+#else
+        KIT_LOG(LOG_IO, KitLogLevel::LOG_INFO, "Resource hot reload is only supported on Linux");
+#endif
+
+        return true;
+    }
+
+    void KitResourceWatcherSystem::Update(const float dt)
+    {
+#ifdef __linux__
+        if (inotify_fd_ < 0)
+        {
+            return;
+        }
+
+        // A single save usually produces several events, only reload each file once per frame
+        std::unordered_set<std::string> changed_files;
+
+        alignas(inotify_event) char buffer[4096];
+
+        while (true)
+        {
+            const ssize_t length = read(inotify_fd_, buffer, sizeof(buffer));
+            if (length <= 0)
+            {
+                break;
+            }
+
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                const auto directory = watched_directories_.find(event->wd);
+                if (event->len == 0 || directory == watched_directories_.end())
+                {
+                    continue;
+                }
+
+                changed_files.insert(NormalizePath(directory->second / event->name));
+            }
+        }
+
+        for (const std::string& file_path : changed_files)
+        {
+            OnFileChanged(file_path);
+        }
+#endif
+    }
+
+    bool KitResourceWatcherSystem::End()
+    {
+        watched_files_.clear();
+        return true;
+    }
+
+    KitResourceWatcherSystem::~KitResourceWatcherSystem()
+    {
+#ifdef __linux__
+        if (inotify_fd_ >= 0)
+        {
+            close(inotify_fd_);
+        }
+#endif
+    }
+
+    void KitResourceWatcherSystem::Watch(const std::string& file_path, KitResourceCacheBase* cache, const KitResourceId id)
+    {
+        if (!IsAvailable())
+        {
+            return;
+        }
+
+        const std::string normalized_path = NormalizePath(file_path);
+
+        std::vector<KitWatchedResource>& resources = watched_files_[normalized_path];
+        for (const KitWatchedResource& resource : resources)
+        {
+            if (resource.cache == cache && resource.id == id)
+            {
+                return;
+            }
+        }
+
+        resources.push_back({cache, id});
+
+#ifdef __linux__
+        const std::filesystem::path directory = std::filesystem::path(normalized_path).parent_path();
+        if (directory_descriptors_.contains(directory.string()))
+        {
+            return;
+        }
+
+        const int descriptor = inotify_add_watch(inotify_fd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (descriptor < 0)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Could not watch {} for changes", directory.string());
+            return;
+        }
+
+        watched_directories_[descriptor]           = directory;
+        directory_descriptors_[directory.string()] = descriptor;
+#endif
+    }
+
+    std::string KitResourceWatcherSystem::NormalizePath(const std::filesystem::path& file_path)
+    {
+        std::error_code error;
+        const std::filesystem::path absolute_path = std::filesystem::absolute(file_path, error);
+
+        return (error ? file_path : absolute_path).lexically_normal().string();
+    }
+
+    void KitResourceWatcherSystem::OnFileChanged(const std::string& file_path)
+    {
+        const auto it = watched_files_.find(file_path);
+        if (it == watched_files_.end())
+        {
+            return;
+        }
+
+        KIT_LOG(LOG_IO, KitLogLevel::LOG_INFO, "{} changed, reloading", file_path);
+
+        // Caches refuse resources they no longer hold, those stop being watched
+        std::erase_if(
+            it->second,
+            [](const KitWatchedResource& resource)
+            {
+                return !resource.cache->Reload(resource.id);
+            });
+
+        if (it->second.empty())
+        {
+            watched_files_.erase(it);
+        }
+    }
+} // Kitsune
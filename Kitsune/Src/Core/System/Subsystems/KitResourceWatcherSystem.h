@@ -0,0 +1,50 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Core/KitResourceId.h"
+#include "Core/System/KitSystem.h"
+
+namespace Kitsune
+{
+    class KitResourceCacheBase;
+
+    // Watches the source files of loaded resources and asks their cache to reload them when they change.
+    // Uses inotify on Linux, other platforms load normally without hot reload.
+    class KitResourceWatcherSystem final : public KitSystem
+    {
+        struct KitWatchedResource
+        {
+            KitResourceCacheBase* cache;
+            KitResourceId         id;
+        };
+
+        int inotify_fd_ = -1;
+
+        // Directories are watched rather than files so editors that save through a rename are still seen
+        std::unordered_map<int, std::filesystem::path> watched_directories_;
+        std::unordered_map<std::string, int>           directory_descriptors_;
+
+        std::unordered_map<std::string, std::vector<KitWatchedResource>> watched_files_;
+
+    protected:
+        bool Init(KitEngineDevice* device) override;
+        void Update(const float dt) override;
+        bool End() override;
+
+    public:
+        ~KitResourceWatcherSystem() override;
+
+        // Safe to call again for a resource that is already watched
+        void Watch(const std::string& file_path, KitResourceCacheBase* cache, KitResourceId id);
+
+        KIT_NODISCARD bool IsAvailable() const { return inotify_fd_ >= 0; }
+
+    private:
+        static std::string NormalizePath(const std::filesystem::path& file_path);
+        void OnFileChanged(const std::string& file_path);
+    };
+} // Kitsune
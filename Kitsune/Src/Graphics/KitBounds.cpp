@@ -0,0 +1,167 @@
+#include "KitBounds.h"
+
+namespace Kitsune
+{
+    KitAabb KitAabb::Transform(const glm::mat4& matrix) const
+    {
+        // Arvo: each output axis takes the smaller and larger product of every matrix entry with the box range
+        KitAabb result{};
+        result.min = glm::vec3(matrix[3]);
+        result.max = glm::vec3(matrix[3]);
+
+        for (int column = 0; column < 3; column++)
+        {
+            const glm::vec3 axis(matrix[column]);
+            const glm::vec3 a = axis * min[column];
+            const glm::vec3 b = axis * max[column];
+
+            result.min += glm::min(a, b);
+            result.max += glm::max(a, b);
+        }
+
+        return result;
+    }
+
+    bool KitAabb::IntersectRay(
+        const glm::vec3& origin,
+        const glm::vec3& inverse_direction,
+        const float      max_distance,
+        float&           distance) const
+    {
+        const glm::vec3 t0 = (min - origin) * inverse_direction;
+        const glm::vec3 t1 = (max - origin) * inverse_direction;
+
+        const glm::vec3 t_near = glm::min(t0, t1);
+        const glm::vec3 t_far  = glm::max(t0, t1);
+
+        const float enter = glm::max(glm::max(t_near.x, t_near.y), glm::max(t_near.z, 0.f));
+        const float exit  = glm::min(glm::min(t_far.x, t_far.y), glm::min(t_far.z, max_distance));
+
+        if (enter > exit)
+        {
+            return false;
+        }
+
+        distance = enter;
+        return true;
+    }
+
+    KitBoundingSphere KitBoundingSphere::Transform(const glm::mat4& matrix) const
+    {
+        const float scale_squared = glm::max(
+            glm::dot(glm::vec3(matrix[0]), glm::vec3(matrix[0])),
+            glm::max(glm::dot(glm::vec3(matrix[1]), glm::vec3(matrix[1])), glm::dot(glm::vec3(matrix[2]), glm::vec3(matrix[2]))));
+
+        KitBoundingSphere result{};
+        result.center = glm::vec3(matrix * glm::vec4(center, 1.f));
+        result.radius = radius * glm::sqrt(scale_squared);
+
+        return result;
+    }
+
+    void KitMeshBounds::Expand(const KitMeshBounds& other)
+    {
+        if (!aabb.IsValid())
+        {
+            *this = other;
+            return;
+        }
+
+        aabb.Expand(other.aabb);
+
+        // Sphere of the merged box, looser than a minimal sphere but never missing either input
+        const glm::vec3 center = aabb.GetCenter();
+        const float     radius = glm::max(
+            glm::length(sphere.center - center) + sphere.radius,
+            glm::length(other.sphere.center - center) + other.sphere.radius);
+
+        sphere.center = center;
+        sphere.radius = glm::min(radius, glm::length(aabb.GetExtent()));
+    }
+
+    KitFrustum KitFrustum::FromMatrix(const glm::mat4& view_projection)
+    {
+        const auto row = [&view_projection](const int index)
+        {
+            return glm::vec4(view_projection[0][index], view_projection[1][index], view_projection[2][index], view_projection[3][index]);
+        };
+
+        const glm::vec4 row0 = row(0);
+        const glm::vec4 row1 = row(1);
+        const glm::vec4 row2 = row(2);
+        const glm::vec4 row3 = row(3);
+
+        KitFrustum frustum{};
+        frustum.planes[PLANE_LEFT]   = row3 + row0;
+        frustum.planes[PLANE_RIGHT]  = row3 - row0;
+        frustum.planes[PLANE_BOTTOM] = row3 + row1;
+        frustum.planes[PLANE_TOP]    = row3 - row1;
+        frustum.planes[PLANE_NEAR]   = row2;
+        frustum.planes[PLANE_FAR]    = row3 - row2;
+
+        // Normalized so plane distances are real distances for the sphere test
+        for (glm::vec4& plane : frustum.planes)
+        {
+            plane /= glm::length(glm::vec3(plane));
+        }
+
+        return frustum;
+    }
+
+    bool KitFrustum::IsVisible(const KitBoundingSphere& sphere) const
+    {
+        for (const glm::vec4& plane : planes)
+        {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool KitFrustum::IsVisible(const KitAabb& aabb) const
+    {
+        const glm::vec3 center = aabb.GetCenter();
+        const glm::vec3 extent = aabb.GetExtent();
+
+        for (const glm::vec4& plane : planes)
+        {
+            // Projected radius of the box on the plane normal
+            const float radius = glm::dot(extent, glm::abs(glm::vec3(plane)));
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    KitFrustumTest KitFrustum::Classify(const KitAabb& aabb) const
+    {
+        const glm::vec3 center = aabb.GetCenter();
+        const glm::vec3 extent = aabb.GetExtent();
+
+        KitFrustumTest result = KitFrustumTest::INSIDE;
+
+        for (const glm::vec4& plane : planes)
+        {
+            const float radius   = glm::dot(extent, glm::abs(glm::vec3(plane)));
+            const float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+
+            if (distance < -radius)
+            {
+                return KitFrustumTest::OUTSIDE;
+            }
+
+            if (distance < radius)
+            {
+                result = KitFrustumTest::INTERSECTING;
+            }
+        }
+
+        return result;
+    }
+} // Kitsune
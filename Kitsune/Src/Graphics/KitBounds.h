@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <limits>
+#include <span>
+
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+#include "Core/KitDefinitions.h"
+
+namespace Kitsune
+{
+    struct KitAabb
+    {
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+        void Expand(const glm::vec3& point)
+        {
+            min = glm::min(min, point);
+            max = glm::max(max, point);
+        }
+
+        void Expand(const KitAabb& other)
+        {
+            min = glm::min(min, other.min);
+            max = glm::max(max, other.max);
+        }
+
+        KIT_NODISCARD bool IsValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+        KIT_NODISCARD glm::vec3 GetCenter() const { return (min + max) * 0.5f; }
+        KIT_NODISCARD glm::vec3 GetExtent() const { return (max - min) * 0.5f; }
+
+        KIT_NODISCARD float GetSurfaceArea() const
+        {
+            const glm::vec3 size = max - min;
+            return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        KIT_NODISCARD bool Contains(const KitAabb& other) const
+        {
+            return min.x <= other.min.x && min.y <= other.min.y && min.z <= other.min.z &&
+                   max.x >= other.max.x && max.y >= other.max.y && max.z >= other.max.z;
+        }
+
+        KIT_NODISCARD bool Overlaps(const KitAabb& other) const
+        {
+            return min.x <= other.max.x && min.y <= other.max.y && min.z <= other.max.z &&
+                   max.x >= other.min.x && max.y >= other.min.y && max.z >= other.min.z;
+        }
+
+        KIT_NODISCARD static KitAabb Union(const KitAabb& a, const KitAabb& b)
+        {
+            return {glm::min(a.min, b.min), glm::max(a.max, b.max)};
+        }
+
+        // Slab test, the inverse direction is passed in so a ray against many boxes divides once
+        KIT_NODISCARD bool IntersectRay(
+            const glm::vec3& origin,
+            const glm::vec3& inverse_direction,
+            float            max_distance,
+            float&           distance) const;
+
+        // Box around the transformed box, exact for the corners without transforming all eight
+        KIT_NODISCARD KitAabb Transform(const glm::mat4& matrix) const;
+    };
+
+    struct KitBoundingSphere
+    {
+        glm::vec3 center{0.f};
+        float     radius = 0.f;
+
+        // Non uniform scale grows the radius by the largest axis scale
+        KIT_NODISCARD KitBoundingSphere Transform(const glm::mat4& matrix) const;
+
+        KIT_NODISCARD bool Overlaps(const KitAabb& aabb) const
+        {
+            const glm::vec3 closest = glm::clamp(center, aabb.min, aabb.max);
+            const glm::vec3 offset  = closest - center;
+            return glm::dot(offset, offset) <= radius * radius;
+        }
+    };
+
+    // Both volumes of a mesh in model space, the sphere is the cheap first test and the box the tighter one
+    struct KitMeshBounds
+    {
+        KitAabb           aabb;
+        KitBoundingSphere sphere;
+
+        void Expand(const KitMeshBounds& other);
+
+        // Sphere centered on the box, with the radius of the farthest vertex rather than the box corner
+        template<typename TVertex>
+        static KitMeshBounds FromVertices(std::span<const TVertex> vertices)
+        {
+            KitMeshBounds bounds{};
+            if (vertices.empty())
+            {
+                bounds.aabb = {glm::vec3(0.f), glm::vec3(0.f)};
+                return bounds;
+            }
+
+            for (const TVertex& vertex : vertices)
+            {
+                bounds.aabb.Expand(vertex.position);
+            }
+
+            bounds.sphere.center = bounds.aabb.GetCenter();
+
+            float radius_squared = 0.f;
+            for (const TVertex& vertex : vertices)
+            {
+                const glm::vec3 offset = vertex.position - bounds.sphere.center;
+                radius_squared         = glm::max(radius_squared, glm::dot(offset, offset));
+            }
+
+            bounds.sphere.radius = glm::sqrt(radius_squared);
+
+            return bounds;
+        }
+    };
+
+    enum class KitFrustumTest : uint32_t
+    {
+        OUTSIDE,
+        INTERSECTING,
+        INSIDE,
+    };
+
+    // Planes point inwards, a point is inside when it is on the positive side of all six
+    struct KitFrustum
+    {
+        // Windows headers define NEAR and FAR, hence the prefix
+        enum KitFrustumPlane : uint32_t
+        {
+            PLANE_LEFT,
+            PLANE_RIGHT,
+            PLANE_BOTTOM,
+            PLANE_TOP,
+            PLANE_NEAR,
+            PLANE_FAR,
+            PLANE_COUNT
+        };
+
+        std::array<glm::vec4, PLANE_COUNT> planes{};
+
+        // Gribb/Hartmann extraction from a view projection matrix with a [0, 1] depth range
+        static KitFrustum FromMatrix(const glm::mat4& view_projection);
+
+        KIT_NODISCARD bool IsVisible(const KitBoundingSphere& sphere) const;
+        KIT_NODISCARD bool IsVisible(const KitAabb& aabb) const;
+
+        // Tells boxes fully inside apart from intersecting ones, so tree traversals can stop testing below them
+        KIT_NODISCARD KitFrustumTest Classify(const KitAabb& aabb) const;
+    };
+} // Kitsune
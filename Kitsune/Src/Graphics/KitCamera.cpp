@@ -14,6 +14,9 @@ namespace Kitsune
         projection_matrix_[3][0] = -(right + left) / (right - left);
         projection_matrix_[3][1] = -(bottom + top) / (bottom - top);
         projection_matrix_[3][2] = -near / (far - near);
+
+        near_ = near;
+        far_  = far;
     }
 
     void KitCamera::SetPerspectiveProjectionMatrix(const float fov_y, const float aspect_ratio, const float near, const float far)
@@ -25,6 +28,9 @@ namespace Kitsune
         projection_matrix_[2][2] = far / (far - near);
         projection_matrix_[2][3] = 1.f;
         projection_matrix_[3][2] = -(far * near) / (far - near);
+
+        near_ = near;
+        far_  = far;
     }
 
     void KitCamera::SetViewDirection(const glm::vec3& position, const glm::vec3& direction, const glm::vec3& up)
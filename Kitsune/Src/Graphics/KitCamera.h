@@ -5,6 +5,7 @@
 #include <glm/glm.hpp>
 
 #include "Core/KitDefinitions.h"
+#include "KitBounds.h"
 
 namespace Kitsune
 {
@@ -14,10 +15,17 @@ namespace Kitsune
         glm::mat4 view_matrix_{1.f};
         glm::mat4 inverse_view_matrix_{1.f};
 
+        float near_ = 0.f;
+        float far_  = 0.f;
+
     public:
         KIT_NODISCARD const glm::mat4& GetProjectionMatrix() const { return projection_matrix_; }
         KIT_NODISCARD const glm::mat4& GetViewMatrix() const { return view_matrix_; }
         KIT_NODISCARD const glm::mat4& GetInverseViewMatrix() const { return inverse_view_matrix_; }
+        KIT_NODISCARD KitFrustum GetFrustum() const { return KitFrustum::FromMatrix(projection_matrix_ * view_matrix_); }
+        KIT_NODISCARD float GetNear() const { return near_; }
+        KIT_NODISCARD float GetFar() const { return far_; }
+        KIT_NODISCARD bool IsPerspective() const { return projection_matrix_[2][3] != 0.f; }
 
         void SetOrthographicProjectionMatrix(
             const float left,
@@ -0,0 +1,256 @@
+#include "KitClusteredLighting.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/KitLogs.h"
+#include "KitSwapChain.h"
+
+namespace Kitsune
+{
+    KitClusteredLighting::KitClusteredLighting(KitEngineDevice* device)
+    {
+        frame_buffers_.resize(KitSwapChain::MAX_FRAMES_IN_FLIGHT);
+
+        for (KitFrameBuffers& buffers : frame_buffers_)
+        {
+            buffers.lights = std::make_unique<KitGraphicsBuffer>(
+                device,
+                sizeof(PointLightData),
+                MAX_LIGHTS,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+            buffers.clusters = std::make_unique<KitGraphicsBuffer>(
+                device,
+                sizeof(ClusterData),
+                CLUSTER_COUNT,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+            buffers.light_indices = std::make_unique<KitGraphicsBuffer>(
+                device,
+                sizeof(uint32_t),
+                MAX_CLUSTER_LIGHT_INDICES,
+                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+            buffers.lights->Map();
+            buffers.clusters->Map();
+            buffers.light_indices->Map();
+        }
+
+        clusters_.resize(CLUSTER_COUNT);
+    }
+
+    void KitClusteredLighting::Update(
+        const int        frame_index,
+        const KitCamera& camera,
+        const VkExtent2D extent,
+        const KitScene&  scene,
+        KitGlobalUBO&    ubo)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, camera.IsPerspective() && camera.GetNear() > 0.f,
+                   "Clustered lighting needs a perspective camera with a positive near plane");
+
+        lights_.clear();
+        scene.GetPointLightQuery().each(
+            [this](const KitTransform&, const KitWorldTransform& world_transform, const KitColorComponent& color,
+                   const KitPointLightComponent& point_light)
+            {
+                if (lights_.size() == MAX_LIGHTS)
+                {
+                    return;
+                }
+
+                const float range = std::sqrt(point_light.light_intensity / LIGHT_CUTOFF);
+
+                // Lights attached to a parent have a relative transform, only the world matrix holds where they are
+                const glm::vec3 position(world_transform.model_matrix[3]);
+
+                lights_.push_back({glm::vec4(position, range), glm::vec4(color.color, point_light.light_intensity)});
+            });
+
+        AssignLights(camera);
+
+        const float depth_log_range = std::log(camera.GetFar() / camera.GetNear());
+
+        ubo.num_lights      = static_cast<int>(lights_.size());
+        ubo.cluster_scale.x = static_cast<float>(CLUSTER_COUNT_X) / static_cast<float>(extent.width);
+        ubo.cluster_scale.y = static_cast<float>(CLUSTER_COUNT_Y) / static_cast<float>(extent.height);
+        ubo.cluster_scale.z = CLUSTER_COUNT_Z / depth_log_range;
+        ubo.cluster_scale.w = -CLUSTER_COUNT_Z * std::log(camera.GetNear()) / depth_log_range;
+
+        const KitFrameBuffers& buffers = frame_buffers_[frame_index];
+
+        // Manual flushes, the buffers are not host coherent
+        if (!lights_.empty())
+        {
+            buffers.lights->WriteToBuffer(lights_.data(), lights_.size() * sizeof(PointLightData));
+            buffers.lights->Flush();
+        }
+
+        buffers.clusters->WriteToBuffer(clusters_.data(), clusters_.size() * sizeof(ClusterData));
+        buffers.clusters->Flush();
+
+        if (!light_indices_.empty())
+        {
+            buffers.light_indices->WriteToBuffer(light_indices_.data(), light_indices_.size() * sizeof(uint32_t));
+            buffers.light_indices->Flush();
+        }
+    }
+
+    VkDescriptorBufferInfo KitClusteredLighting::GetLightBufferInfo(const int frame_index) const
+    {
+        return frame_buffers_[frame_index].lights->DescriptorInfo();
+    }
+
+    VkDescriptorBufferInfo KitClusteredLighting::GetClusterBufferInfo(const int frame_index) const
+    {
+        return frame_buffers_[frame_index].clusters->DescriptorInfo();
+    }
+
+    VkDescriptorBufferInfo KitClusteredLighting::GetLightIndexBufferInfo(const int frame_index) const
+    {
+        return frame_buffers_[frame_index].light_indices->DescriptorInfo();
+    }
+
+    void KitClusteredLighting::AssignLights(const KitCamera& camera)
+    {
+        cluster_lights_.clear();
+
+        const glm::mat4& view       = camera.GetViewMatrix();
+        const glm::mat4& projection = camera.GetProjectionMatrix();
+        const float      near       = camera.GetNear();
+        const float      far        = camera.GetFar();
+
+        const auto slice_depth = [near, far](const uint32_t slice)
+        {
+            return near * std::pow(far / near, static_cast<float>(slice) / CLUSTER_COUNT_Z);
+        };
+
+        const auto slice_of = [near, far](const float depth)
+        {
+            const float slice = std::log(depth / near) / std::log(far / near) * CLUSTER_COUNT_Z;
+            return static_cast<uint32_t>(std::clamp(slice, 0.f, CLUSTER_COUNT_Z - 1.f));
+        };
+
+        // Tile range covering [low, high] seen anywhere between two depths, the projection divides by the depth
+        const auto tile_range = [](
+            const float low,
+            const float high,
+            const float near_depth,
+            const float far_depth,
+            const float scale,
+            const int   tile_count,
+            uint32_t&   first,
+            uint32_t&   last)
+        {
+            const float a = low * scale / near_depth;
+            const float b = low * scale / far_depth;
+            const float c = high * scale / near_depth;
+            const float d = high * scale / far_depth;
+
+            const float ndc_min = std::min(std::min(a, b), std::min(c, d));
+            const float ndc_max = std::max(std::max(a, b), std::max(c, d));
+
+            if (ndc_max < -1.f || ndc_min > 1.f)
+            {
+                return false;
+            }
+
+            const float tiles = static_cast<float>(tile_count);
+            first = static_cast<uint32_t>(std::clamp((ndc_min * 0.5f + 0.5f) * tiles, 0.f, tiles - 1.f));
+            last  = static_cast<uint32_t>(std::clamp((ndc_max * 0.5f + 0.5f) * tiles, 0.f, tiles - 1.f));
+            return true;
+        };
+
+        for (uint32_t light_index = 0; light_index < lights_.size(); light_index++)
+        {
+            const PointLightData& light  = lights_[light_index];
+            const glm::vec3       center = glm::vec3(view * glm::vec4(glm::vec3(light.position), 1.f));
+            const float           range  = light.position.w;
+
+            if (center.z + range < near || center.z - range > far)
+            {
+                continue;
+            }
+
+            const uint32_t first_slice = slice_of(std::max(center.z - range, near));
+            const uint32_t last_slice  = slice_of(std::min(center.z + range, far));
+
+            for (uint32_t slice = first_slice; slice <= last_slice; slice++)
+            {
+                const float slab_near = std::max(slice_depth(slice), center.z - range);
+                const float slab_far  = std::min(slice_depth(slice + 1), center.z + range);
+
+                if (slab_near > slab_far)
+                {
+                    continue;
+                }
+
+                // Widest cross section of the sphere within the slab
+                const float closest_depth = std::clamp(center.z, slab_near, slab_far);
+                const float offset        = closest_depth - center.z;
+                const float radius        = std::sqrt(std::max(range * range - offset * offset, 0.f));
+
+                uint32_t first_x, last_x, first_y, last_y;
+                if (!tile_range(center.x - radius, center.x + radius, slab_near, slab_far, projection[0][0], CLUSTER_COUNT_X,
+                                first_x, last_x) ||
+                    !tile_range(center.y - radius, center.y + radius, slab_near, slab_far, projection[1][1], CLUSTER_COUNT_Y,
+                                first_y, last_y))
+                {
+                    continue;
+                }
+
+                for (uint32_t y = first_y; y <= last_y; y++)
+                {
+                    for (uint32_t x = first_x; x <= last_x; x++)
+                    {
+                        const uint32_t cluster = x + CLUSTER_COUNT_X * (y + CLUSTER_COUNT_Y * slice);
+                        cluster_lights_.push_back({cluster, light_index});
+                    }
+                }
+            }
+        }
+
+        if (cluster_lights_.size() > MAX_CLUSTER_LIGHT_INDICES)
+        {
+            if (!has_overflowed_)
+            {
+                KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_WARNING,
+                        "{} cluster light references exceed the capacity of {}, the extra lights are dropped",
+                        cluster_lights_.size(), MAX_CLUSTER_LIGHT_INDICES);
+                has_overflowed_ = true;
+            }
+
+            cluster_lights_.resize(MAX_CLUSTER_LIGHT_INDICES);
+        }
+
+        // Counting sort by cluster, lights stay in their original order inside each cluster
+        for (ClusterData& cluster : clusters_)
+        {
+            cluster = {0, 0};
+        }
+
+        for (const KitClusterLight& cluster_light : cluster_lights_)
+        {
+            clusters_[cluster_light.cluster].count++;
+        }
+
+        uint32_t offset = 0;
+        for (ClusterData& cluster : clusters_)
+        {
+            cluster.offset = offset;
+            offset += cluster.count;
+            cluster.count = 0;
+        }
+
+        light_indices_.resize(cluster_lights_.size());
+        for (const KitClusterLight& cluster_light : cluster_lights_)
+        {
+            ClusterData& cluster = clusters_[cluster_light.cluster];
+            light_indices_[cluster.offset + cluster.count++] = cluster_light.light;
+        }
+    }
+} // Kitsune
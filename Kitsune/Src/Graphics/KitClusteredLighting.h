@@ -0,0 +1,63 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Core/KitDefinitions.h"
+#include "Core/Scene/KitScene.h"
+#include "KitCamera.h"
+#include "KitGlobalGraphicsDefines.h"
+#include "KitGraphicsBuffer.h"
+
+namespace Kitsune
+{
+    // Splits the view frustum into CLUSTER_COUNT_X * CLUSTER_COUNT_Y screen tiles and CLUSTER_COUNT_Z exponential depth
+    // slices and lists the point lights reaching each cluster, so a fragment only shades the lights of its own cluster.
+    // Lights get a range from their intensity, past which their contribution falls under LIGHT_CUTOFF.
+    // Assignment runs on the CPU once per frame and fills three storage buffers per frame in flight:
+    // the lights (binding 1), the offset and count of each cluster (binding 2) and the light index list (binding 3).
+    class KitClusteredLighting
+    {
+        static constexpr float LIGHT_CUTOFF = 0.005f;
+
+        struct KitFrameBuffers
+        {
+            std::unique_ptr<KitGraphicsBuffer> lights;
+            std::unique_ptr<KitGraphicsBuffer> clusters;
+            std::unique_ptr<KitGraphicsBuffer> light_indices;
+        };
+
+        struct KitClusterLight
+        {
+            uint32_t cluster;
+            uint32_t light;
+        };
+
+        std::vector<KitFrameBuffers> frame_buffers_;
+
+        // Scratch reused every frame
+        std::vector<PointLightData>  lights_;
+        std::vector<KitClusterLight> cluster_lights_;
+        std::vector<ClusterData>     clusters_;
+        std::vector<uint32_t>        light_indices_;
+
+        bool has_overflowed_ = false;
+
+    public:
+        explicit KitClusteredLighting(KitEngineDevice* device);
+
+        // Gathers the point lights of the scene and assigns them to the clusters of the camera, writes the light count and
+        // the cluster scales to the ubo. The camera must use a perspective projection.
+        void Update(int frame_index, const KitCamera& camera, VkExtent2D extent, const KitScene& scene, KitGlobalUBO& ubo);
+
+        KIT_NODISCARD VkDescriptorBufferInfo GetLightBufferInfo(int frame_index) const;
+        KIT_NODISCARD VkDescriptorBufferInfo GetClusterBufferInfo(int frame_index) const;
+        KIT_NODISCARD VkDescriptorBufferInfo GetLightIndexBufferInfo(int frame_index) const;
+
+        // Light references over all clusters, the per pixel cost follows this rather than the light count
+        KIT_NODISCARD size_t GetLightIndexCount() const { return light_indices_.size(); }
+
+    private:
+        void AssignLights(const KitCamera& camera);
+    };
+} // Kitsune
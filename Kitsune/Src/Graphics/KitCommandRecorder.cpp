@@ -0,0 +1,121 @@
+#include "KitCommandRecorder.h"
+
+#include "Core/KitLogs.h"
+#include "KitSwapChain.h"
+
+namespace Kitsune
+{
+    KitCommandRecorder::KitCommandRecorder(KitEngineDevice* device, const uint32_t participant_count):
+        engine_device_(device)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, participant_count > 0, "Command recorder needs at least one participant");
+
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.queueFamilyIndex = engine_device_->FindQueueFamilies().graphics_family.value();
+        pool_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        frame_pools_.resize(KitSwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (std::vector<KitThreadPool>& pools : frame_pools_)
+        {
+            pools.resize(participant_count);
+            for (KitThreadPool& pool : pools)
+            {
+                VkResult result = vkCreateCommandPool(engine_device_->GetDevice(), &pool_info, nullptr, &pool.command_pool);
+                KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create recording command pool!");
+            }
+        }
+    }
+
+    KitCommandRecorder::~KitCommandRecorder()
+    {
+        // Destroying a pool frees its buffers
+        for (const std::vector<KitThreadPool>& pools : frame_pools_)
+        {
+            for (const KitThreadPool& pool : pools)
+            {
+                vkDestroyCommandPool(engine_device_->GetDevice(), pool.command_pool, nullptr);
+            }
+        }
+    }
+
+    void KitCommandRecorder::BeginFrame(
+        const int           frame_index,
+        const VkRenderPass  render_pass,
+        const VkFramebuffer framebuffer,
+        const VkExtent2D    extent)
+    {
+        frame_index_ = frame_index;
+        render_pass_ = render_pass;
+        framebuffer_ = framebuffer;
+        extent_      = extent;
+
+        for (KitThreadPool& pool : frame_pools_[frame_index_])
+        {
+            if (pool.used_count == 0)
+            {
+                continue;
+            }
+
+            VkResult result = vkResetCommandPool(engine_device_->GetDevice(), pool.command_pool, 0);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to reset recording command pool!");
+
+            pool.used_count = 0;
+        }
+    }
+
+    VkCommandBuffer KitCommandRecorder::Begin(const uint32_t participant)
+    {
+        KitThreadPool& pool = frame_pools_[frame_index_][participant];
+
+        if (pool.used_count == pool.command_buffers.size())
+        {
+            VkCommandBufferAllocateInfo allocate_info{};
+            allocate_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocate_info.level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+            allocate_info.commandPool        = pool.command_pool;
+            allocate_info.commandBufferCount = 1;
+
+            VkCommandBuffer command_buffer;
+            VkResult result = vkAllocateCommandBuffers(engine_device_->GetDevice(), &allocate_info, &command_buffer);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to allocate secondary command buffer!");
+
+            pool.command_buffers.push_back(command_buffer);
+        }
+
+        const VkCommandBuffer command_buffer = pool.command_buffers[pool.used_count++];
+
+        VkCommandBufferInheritanceInfo inheritance_info{};
+        inheritance_info.sType       = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance_info.renderPass  = render_pass_;
+        inheritance_info.subpass     = 0;
+        inheritance_info.framebuffer = framebuffer_;
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType            = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags            = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+        begin_info.pInheritanceInfo = &inheritance_info;
+
+        VkResult result = vkBeginCommandBuffer(command_buffer, &begin_info);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to begin secondary command buffer!");
+
+        VkViewport viewport{};
+        viewport.x        = 0.0f;
+        viewport.y        = 0.0f;
+        viewport.width    = static_cast<float>(extent_.width);
+        viewport.height   = static_cast<float>(extent_.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        VkRect2D scissor{{0, 0}, extent_};
+        vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+        vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+        return command_buffer;
+    }
+
+    void KitCommandRecorder::End(const VkCommandBuffer command_buffer) const
+    {
+        VkResult result = vkEndCommandBuffer(command_buffer);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to end secondary command buffer!");
+    }
+} // Kitsune
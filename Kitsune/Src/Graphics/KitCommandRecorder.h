@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "KitEngineDevice.h"
+
+namespace Kitsune
+{
+    // Hands out secondary command buffers continuing the swap chain render pass, recorded by job system participants
+    // in parallel. Each frame in flight has one transient pool per participant, so threads never share a pool and
+    // nothing needs locking. The pools of a frame are reset as a whole when it begins, its buffers are reused rather
+    // than freed.
+    class KitCommandRecorder final
+    {
+        struct KitThreadPool
+        {
+            VkCommandPool                command_pool = VK_NULL_HANDLE;
+            std::vector<VkCommandBuffer> command_buffers;
+            uint32_t                     used_count = 0;
+        };
+
+        KitEngineDevice* engine_device_;
+
+        // Indexed by frame, then by participant
+        std::vector<std::vector<KitThreadPool>> frame_pools_;
+        int                                     frame_index_ = 0;
+
+        VkRenderPass  render_pass_ = VK_NULL_HANDLE;
+        VkFramebuffer framebuffer_ = VK_NULL_HANDLE;
+        VkExtent2D    extent_{};
+
+    public:
+        KitCommandRecorder(KitEngineDevice* device, uint32_t participant_count);
+        ~KitCommandRecorder();
+
+        KitCommandRecorder(const KitCommandRecorder&) = delete;
+        KitCommandRecorder(KitCommandRecorder&&)      = delete;
+
+        KitCommandRecorder& operator=(const KitCommandRecorder&) = delete;
+        KitCommandRecorder& operator=(KitCommandRecorder&&)      = delete;
+
+        KIT_NODISCARD uint32_t GetParticipantCount() const { return static_cast<uint32_t>(frame_pools_.front().size()); }
+
+        // The frame's fence has been waited on, none of its buffers is still pending
+        void BeginFrame(int frame_index, VkRenderPass render_pass, VkFramebuffer framebuffer, VkExtent2D extent);
+
+        // Secondaries inherit no dynamic state, the viewport and scissor are set on every buffer
+        VkCommandBuffer Begin(uint32_t participant);
+        void End(VkCommandBuffer command_buffer) const;
+    };
+} // Kitsune
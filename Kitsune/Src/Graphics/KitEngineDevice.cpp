@@ -1,8 +1,14 @@
 ﻿#include "KitEngineDevice.h"
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <set>
 
 #include "Core/KitLogs.h"
+#include "KitGeometryArena.h"
+#include "KitModel.h"
+#include "KitUploadManager.h"
 
 #include <unordered_set>
 
@@ -144,11 +150,24 @@ namespace Kitsune
             std::vector<VkPhysicalDevice> devices(device_count);
             vkEnumeratePhysicalDevices(vk_instance_, &device_count, devices.data());
 
+            // A discrete GPU first, otherwise any suitable device such as an integrated GPU or lavapipe
             for (const auto& device : devices)
             {
-                if (IsDeviceSuitable(device))
+                if (!IsDeviceSuitable(device))
+                {
+                    continue;
+                }
+
+                VkPhysicalDeviceProperties device_properties;
+                vkGetPhysicalDeviceProperties(device, &device_properties);
+
+                if (physical_device_ == VK_NULL_HANDLE || device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
                 {
                     physical_device_ = device;
+                }
+
+                if (device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+                {
                     break;
                 }
             }
@@ -179,15 +198,31 @@ namespace Kitsune
                 queue_create_infos.push_back(queue_create_info);
             }
 
+            VkPhysicalDeviceFeatures supported_features;
+            vkGetPhysicalDeviceFeatures(physical_device_, &supported_features);
+
             VkPhysicalDeviceFeatures device_features{};
+            device_features.multiDrawIndirect         = supported_features.multiDrawIndirect;
+            device_features.drawIndirectFirstInstance = supported_features.drawIndirectFirstInstance;
+
+            is_multi_draw_indirect_supported_ = supported_features.multiDrawIndirect && supported_features.drawIndirectFirstInstance;
+
+            std::vector<const char*> enabled_extensions = device_extensions_;
+
+            const bool is_draw_indirect_count_available =
+                IsDeviceExtensionAvailable(physical_device_, VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+            if (is_draw_indirect_count_available)
+            {
+                enabled_extensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+            }
 
             VkDeviceCreateInfo create_info{};
             create_info.sType                   = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
             create_info.pQueueCreateInfos       = queue_create_infos.data();
             create_info.queueCreateInfoCount    = static_cast<uint32_t>(queue_create_infos.size());
             create_info.pEnabledFeatures        = &device_features;
-            create_info.enabledExtensionCount   = static_cast<uint32_t>(device_extensions_.size());
-            create_info.ppEnabledExtensionNames = device_extensions_.data();
+            create_info.enabledExtensionCount   = static_cast<uint32_t>(enabled_extensions.size());
+            create_info.ppEnabledExtensionNames = enabled_extensions.data();
 
             if (enable_validation_layers_)
             {
@@ -205,6 +240,12 @@ namespace Kitsune
 
             vkGetDeviceQueue(logical_device_, indices.graphics_family.value(), 0, &graphics_queue_);
             vkGetDeviceQueue(logical_device_, indices.present_family.value(), 0, &present_queue_);
+
+            if (is_draw_indirect_count_available)
+            {
+                cmd_draw_indexed_indirect_count_ = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(
+                    vkGetDeviceProcAddr(logical_device_, "vkCmdDrawIndexedIndirectCountKHR"));
+            }
         }
         // --- End creating logical device ---
 
@@ -222,12 +263,31 @@ namespace Kitsune
             KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create command pool!");
         }
         // --- End create command pool ---
+
+        CreatePipelineCache();
+
+        memory_allocator_ = std::make_unique<KitMemoryAllocator>(physical_device_, logical_device_);
+        upload_manager_   = std::make_unique<KitUploadManager>(this);
+
+        for (const KitVertexLayout layout : {KitVertexLayout::STANDARD, KitVertexLayout::PACKED})
+        {
+            geometry_arenas_[static_cast<uint32_t>(layout)] = std::make_unique<KitGeometryArena>(this, GetVertexStride(layout));
+        }
     }
 
     KitEngineDevice::~KitEngineDevice()
     {
         KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, Kitsune::KitLogLevel::LOG_INFO, "Destroying engine device");
+        upload_manager_.reset();
+        for (std::unique_ptr<KitGeometryArena>& geometry_arena : geometry_arenas_)
+        {
+            geometry_arena.reset();
+        }
+        memory_allocator_.reset();
         vkDestroyCommandPool(logical_device_, command_pool_, nullptr);
+
+        SavePipelineCache();
+        vkDestroyPipelineCache(logical_device_, pipeline_cache_, nullptr);
         
         if (enable_validation_layers_)
         {
@@ -289,9 +349,7 @@ namespace Kitsune
 
     bool KitEngineDevice::IsDeviceSuitable(VkPhysicalDevice device) const
     {
-        VkPhysicalDeviceProperties device_properties;
         VkPhysicalDeviceFeatures device_features;
-        vkGetPhysicalDeviceProperties(device, &device_properties);
         vkGetPhysicalDeviceFeatures(device, &device_features);
 
         QueueFamilyIndices family_indices = FindQueueFamilies(device);
@@ -305,8 +363,7 @@ namespace Kitsune
             swap_chain_adequate = swap_chain_support.IsAdequate();
         }
 
-        return device_properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU &&
-            device_features.geometryShader &&
+        return device_features.geometryShader &&
             family_indices.IsComplete() && is_extension_supported && swap_chain_adequate;
     }
 
@@ -325,7 +382,7 @@ namespace Kitsune
         const VkImageCreateInfo& image_info,
         VkMemoryPropertyFlags properties,
         VkImage& image,
-        VkDeviceMemory& image_memory) const
+        KitAllocation& image_allocation) const
     {
         VkResult result = vkCreateImage(logical_device_, &image_info, nullptr, &image);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create image view!");
@@ -333,19 +390,20 @@ namespace Kitsune
         VkMemoryRequirements mem_requirements;
         vkGetImageMemoryRequirements(logical_device_, image, &mem_requirements);
 
-        VkMemoryAllocateInfo alloc_info{};
-        alloc_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        alloc_info.allocationSize  = mem_requirements.size;
-        alloc_info.memoryTypeIndex = FindMemoryType(mem_requirements.memoryTypeBits, properties);
-
-        result = vkAllocateMemory(logical_device_, &alloc_info, nullptr, &image_memory);
-        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to allocate image memory!");
+        const KitMemoryTiling tiling = image_info.tiling == VK_IMAGE_TILING_OPTIMAL ? KitMemoryTiling::OPTIMAL : KitMemoryTiling::LINEAR;
+        image_allocation = memory_allocator_->Allocate(mem_requirements, FindMemoryType(mem_requirements.memoryTypeBits, properties), tiling);
 
-        result = vkBindImageMemory(logical_device_, image, image_memory, 0);
+        result = vkBindImageMemory(logical_device_, image, image_allocation.memory, image_allocation.offset);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to bind image memory!");
     }
 
-    void KitEngineDevice::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& buffer_memory) const
+    void KitEngineDevice::DestroyImage(VkImage image, KitAllocation& image_allocation) const
+    {
+        vkDestroyImage(logical_device_, image, nullptr);
+        memory_allocator_->Free(image_allocation);
+    }
+
+    void KitEngineDevice::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, KitAllocation& buffer_allocation) const
     {
         VkBufferCreateInfo buffer_info{};
         buffer_info.sType       = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -359,15 +417,15 @@ namespace Kitsune
         VkMemoryRequirements mem_requirements;
         vkGetBufferMemoryRequirements(logical_device_, buffer, &mem_requirements);
 
-        VkMemoryAllocateInfo alloc_info{};
-        alloc_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-        alloc_info.allocationSize  = mem_requirements.size;
-        alloc_info.memoryTypeIndex = FindMemoryType(mem_requirements.memoryTypeBits, properties);
+        buffer_allocation = memory_allocator_->Allocate(mem_requirements, FindMemoryType(mem_requirements.memoryTypeBits, properties), KitMemoryTiling::LINEAR);
 
-        result = vkAllocateMemory(logical_device_, &alloc_info, nullptr, &buffer_memory);
-        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Failed to allocate vertex buffer memory!");
+        vkBindBufferMemory(logical_device_, buffer, buffer_allocation.memory, buffer_allocation.offset);
+    }
 
-        vkBindBufferMemory(logical_device_, buffer, buffer_memory, 0);
+    void KitEngineDevice::DestroyBuffer(VkBuffer buffer, KitAllocation& buffer_allocation) const
+    {
+        vkDestroyBuffer(logical_device_, buffer, nullptr);
+        memory_allocator_->Free(buffer_allocation);
     }
 
     VkCommandBuffer KitEngineDevice::BeginSingleTimeCommands() const
@@ -527,6 +585,25 @@ namespace Kitsune
         return required_extensions.empty();
     }
 
+    bool KitEngineDevice::IsDeviceExtensionAvailable(VkPhysicalDevice device, const char* extension) const
+    {
+        uint32_t extension_count;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+
+        std::vector<VkExtensionProperties> available_extensions(extension_count);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, available_extensions.data());
+
+        for (const auto& available_extension : available_extensions)
+        {
+            if (strcmp(available_extension.extensionName, extension) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
     SwapChainSupportDetails KitEngineDevice::QuerySwapChainSupport(VkPhysicalDevice device) const
     {
         SwapChainSupportDetails details;
@@ -574,4 +651,112 @@ namespace Kitsune
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, false, "Fail to locate appropriate memory type!");
         return 0;
     }
+
+    void KitEngineDevice::CreatePipelineCache()
+    {
+        std::vector<char> cache_data;
+
+        std::ifstream file(PIPELINE_CACHE_PATH, std::ios::ate | std::ios::binary);
+        if (file.is_open())
+        {
+            cache_data.resize(static_cast<size_t>(file.tellg()));
+            file.seekg(0);
+            file.read(cache_data.data(), static_cast<std::streamsize>(cache_data.size()));
+
+            if (!file.good())
+            {
+                cache_data.clear();
+            }
+        }
+
+        // Drivers are expected to reject foreign data themselves, not all of them do
+        if (!cache_data.empty())
+        {
+            VkPipelineCacheHeaderVersionOne header{};
+            if (cache_data.size() >= sizeof(header))
+            {
+                std::memcpy(&header, cache_data.data(), sizeof(header));
+            }
+
+            const bool is_valid = cache_data.size() >= sizeof(header) &&
+                                  header.headerSize >= sizeof(header) &&
+                                  header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+                                  header.vendorID == properties.vendorID &&
+                                  header.deviceID == properties.deviceID &&
+                                  std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+
+            if (is_valid)
+            {
+                KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO, "Loaded pipeline cache of {} bytes", cache_data.size());
+            }
+            else
+            {
+                KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO, "Pipeline cache is from another device or driver, rebuilding");
+                cache_data.clear();
+            }
+        }
+
+        VkPipelineCacheCreateInfo create_info{};
+        create_info.sType           = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+        create_info.initialDataSize = cache_data.size();
+        create_info.pInitialData    = cache_data.empty() ? nullptr : cache_data.data();
+
+        VkResult result = vkCreatePipelineCache(logical_device_, &create_info, nullptr, &pipeline_cache_);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create pipeline cache!");
+    }
+
+    void KitEngineDevice::SavePipelineCache() const
+    {
+        size_t cache_size = 0;
+        VkResult result   = vkGetPipelineCacheData(logical_device_, pipeline_cache_, &cache_size, nullptr);
+        if (result != VK_SUCCESS || cache_size == 0)
+        {
+            return;
+        }
+
+        std::vector<char> cache_data(cache_size);
+        result = vkGetPipelineCacheData(logical_device_, pipeline_cache_, &cache_size, cache_data.data());
+        if (result != VK_SUCCESS)
+        {
+            KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_WARNING, "Could not read back the pipeline cache");
+            return;
+        }
+
+        const std::filesystem::path cache_path = PIPELINE_CACHE_PATH;
+
+        std::error_code error;
+        std::filesystem::create_directories(cache_path.parent_path(), error);
+        if (error)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Could not create pipeline cache directory: {}", error.message());
+            return;
+        }
+
+        // Written aside and renamed so a crash never leaves a half written cache behind
+        std::filesystem::path temp_path = cache_path;
+        temp_path += ".tmp";
+
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            file.write(cache_data.data(), static_cast<std::streamsize>(cache_size));
+
+            if (!file.good())
+            {
+                KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Failed writing pipeline cache file: {}", temp_path.string());
+                file.close();
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+        }
+
+        std::filesystem::rename(temp_path, cache_path, error);
+        if (error)
+        {
+            KIT_LOG(LOG_IO, KitLogLevel::LOG_WARNING, "Could not move pipeline cache file into place: {}", error.message());
+            std::filesystem::remove(temp_path, error);
+            return;
+        }
+
+        KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO, "Saved pipeline cache of {} bytes", cache_size);
+    }
 }
@@ -1,12 +1,20 @@
 ﻿#pragma once
+#include <array>
+#include <memory>
 #include <optional>
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
+#include "KitMemoryAllocator.h"
 #include "KitWindow.h"
 
 namespace Kitsune
 {
+    class KitGeometryArena;
+    class KitUploadManager;
+
+    enum class KitVertexLayout : uint32_t;
+
     struct QueueFamilyIndices
     {
         std::optional<uint32_t> graphics_family;
@@ -57,6 +65,20 @@ namespace Kitsune
 
         VkCommandPool command_pool_;
 
+        std::unique_ptr<KitMemoryAllocator> memory_allocator_;
+        std::unique_ptr<KitUploadManager>   upload_manager_;
+
+        // One per KitVertexLayout
+        std::array<std::unique_ptr<KitGeometryArena>, 2> geometry_arenas_;
+
+        // Optional, GPU driven rendering needs multi draw indirect and falls back to fixed count draws without the count
+        bool                                 is_multi_draw_indirect_supported_ = false;
+        PFN_vkCmdDrawIndexedIndirectCountKHR cmd_draw_indexed_indirect_count_  = nullptr;
+
+        // Shared by every pipeline, loaded at startup and saved back on destruction
+        static constexpr const char* PIPELINE_CACHE_PATH = "Cache/pipeline_cache.bin";
+        VkPipelineCache              pipeline_cache_     = VK_NULL_HANDLE;
+
     public:
         VkPhysicalDeviceProperties properties;
 
@@ -76,7 +98,25 @@ namespace Kitsune
         KIT_NODISCARD VkQueue GetPresentQueue() const      { return present_queue_; }
         KIT_NODISCARD VkSurfaceKHR GetSurface() const      { return surface_; }
         KIT_NODISCARD VkCommandPool GetCommandPool() const { return command_pool_; }
+        KIT_NODISCARD VkPipelineCache GetPipelineCache() const { return pipeline_cache_; }
         KIT_NODISCARD KitWindow* GetWindow() const         { return window_; }
+        KIT_NODISCARD KitMemoryAllocator* GetMemoryAllocator() const { return memory_allocator_.get(); }
+        KIT_NODISCARD KitUploadManager* GetUploadManager() const     { return upload_manager_.get(); }
+
+        KIT_NODISCARD KitGeometryArena* GetGeometryArena(const KitVertexLayout layout) const
+        {
+            return geometry_arenas_[static_cast<uint32_t>(layout)].get();
+        }
+
+        // Multi draw indirect with a non zero first instance
+        KIT_NODISCARD bool IsMultiDrawIndirectSupported() const { return is_multi_draw_indirect_supported_; }
+
+        // VK_KHR_draw_indirect_count, null when the device does not expose it
+        KIT_NODISCARD PFN_vkCmdDrawIndexedIndirectCountKHR GetCmdDrawIndexedIndirectCount() const
+        {
+            return cmd_draw_indexed_indirect_count_;
+        }
+
         KIT_NODISCARD std::vector<const char*> GetRequiredExtensions() const;
 
         KIT_NODISCARD bool IsValidationLayerSupported() const;
@@ -86,9 +126,11 @@ namespace Kitsune
         QueueFamilyIndices FindQueueFamilies() const;
 
         VkFormat FindSupportedFormat(const std::vector<VkFormat> &candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
-        void CreateImageWithInfo(const VkImageCreateInfo& image_info, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& image_memory) const;
+        void CreateImageWithInfo(const VkImageCreateInfo& image_info, VkMemoryPropertyFlags properties, VkImage& image, KitAllocation& image_allocation) const;
+        void DestroyImage(VkImage image, KitAllocation& image_allocation) const;
 
-        void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, VkDeviceMemory &buffer_memory) const;
+        void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer &buffer, KitAllocation &buffer_allocation) const;
+        void DestroyBuffer(VkBuffer buffer, KitAllocation& buffer_allocation) const;
 
         VkCommandBuffer BeginSingleTimeCommands() const;
         void EndSingleTimeCommands(VkCommandBuffer command_buffer) const;
@@ -100,8 +142,13 @@ namespace Kitsune
 
         QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device) const;
         bool CheckDeviceExtensionSupport(VkPhysicalDevice device) const;
+        bool IsDeviceExtensionAvailable(VkPhysicalDevice device, const char* extension) const;
         SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device) const;
 
+        // Starts empty when the file is missing or was written by another device or driver
+        void CreatePipelineCache();
+        void SavePipelineCache() const;
+
         uint32_t FindMemoryType(uint32_t type_filter, VkMemoryPropertyFlags properties) const;
     };
 }
@@ -0,0 +1,129 @@
+#include "KitFrustumCuller.h"
+
+#include "KitModel.h"
+
+namespace Kitsune
+{
+    void KitFrustumCuller::Cull(const KitScene& scene, const KitFrustum& frustum, KitJobSystem* job_system)
+    {
+        visible_meshes_.clear();
+        stats_ = {};
+
+        const KitBvh& bvh = scene.GetBvh();
+
+        if (job_system == nullptr || bvh.GetProxyCount() < PARALLEL_OBJECT_COUNT)
+        {
+            bvh.Query(
+                frustum,
+                [this, &scene, &frustum](const int32_t proxy, const bool is_inside)
+                {
+                    CullModel(scene, frustum, proxy, is_inside, visible_meshes_, stats_);
+                });
+
+            stats_.visible = static_cast<uint32_t>(visible_meshes_.size());
+            stats_.culled  = stats_.tested - stats_.visible;
+            return;
+        }
+
+        const uint32_t participant_count = job_system->GetParticipantCount();
+
+        bvh.SplitQuery(frustum, participant_count * CHUNKS_PER_PARTICIPANT, subtrees_);
+
+        workers_.resize(participant_count);
+        for (KitCullingWorker& worker : workers_)
+        {
+            worker.visible_meshes.clear();
+            worker.stats = {};
+        }
+
+        // Every chunk writes its own entry, no two participants touch the same one
+        culled_chunks_.resize(subtrees_.size());
+
+        job_system->ParallelFor(
+            static_cast<uint32_t>(subtrees_.size()),
+            [this, &scene, &frustum, &bvh](const uint32_t chunk, const uint32_t participant)
+            {
+                KitCullingWorker& worker = workers_[participant];
+                const uint32_t    begin  = static_cast<uint32_t>(worker.visible_meshes.size());
+
+                bvh.Query(
+                    frustum,
+                    subtrees_[chunk],
+                    [&scene, &frustum, &worker](const int32_t proxy, const bool is_inside)
+                    {
+                        CullModel(scene, frustum, proxy, is_inside, worker.visible_meshes, worker.stats);
+                    });
+
+                culled_chunks_[chunk] = {participant, begin, static_cast<uint32_t>(worker.visible_meshes.size())};
+            });
+
+        // Chunks are appended in traversal order whoever culled them, the draw order matches a single threaded pass
+        for (const KitCulledChunk& chunk : culled_chunks_)
+        {
+            const std::vector<KitVisibleMesh>& worker_meshes = workers_[chunk.worker].visible_meshes;
+            visible_meshes_.insert(visible_meshes_.end(), worker_meshes.begin() + chunk.begin, worker_meshes.begin() + chunk.end);
+        }
+
+        for (const KitCullingWorker& worker : workers_)
+        {
+            stats_.tested += worker.stats.tested;
+        }
+
+        stats_.visible = static_cast<uint32_t>(visible_meshes_.size());
+        stats_.culled  = stats_.tested - stats_.visible;
+    }
+
+    void KitFrustumCuller::CullModel(
+        const KitScene&              scene,
+        const KitFrustum&            frustum,
+        const int32_t                proxy,
+        const bool                   is_inside,
+        std::vector<KitVisibleMesh>& visible_meshes,
+        KitCullingStats&             stats)
+    {
+        const flecs::entity      entity          = scene.GetEntity(scene.GetBvh().GetUserData(proxy));
+        const KitWorldTransform* transform       = entity.get<KitWorldTransform>();
+        const KitModelComponent* model_component = entity.get<KitModelComponent>();
+        const KitModel*          model           = model_component != nullptr ? scene.GetModel(model_component->model) : nullptr;
+
+        if (transform == nullptr || model == nullptr)
+        {
+            return;
+        }
+
+        const std::vector<KitMesh>& meshes = model->GetMeshes();
+        const glm::mat4&            matrix = transform->model_matrix;
+
+        stats.tested += static_cast<uint32_t>(meshes.size());
+
+        // The fat box of the leaf holds every mesh, nothing inside it can be outside the frustum
+        if (is_inside)
+        {
+            for (const KitMesh& mesh : meshes)
+            {
+                visible_meshes.push_back({&mesh, transform});
+            }
+
+            return;
+        }
+
+        if (!frustum.IsVisible(model->GetBounds().sphere.Transform(matrix)))
+        {
+            return;
+        }
+
+        // The sphere of a single mesh model was just tested
+        const bool is_sphere_tested = meshes.size() == 1;
+
+        for (const KitMesh& mesh : meshes)
+        {
+            const KitMeshBounds& bounds = mesh.GetBounds();
+
+            if ((is_sphere_tested || frustum.IsVisible(bounds.sphere.Transform(matrix))) &&
+                frustum.IsVisible(bounds.aabb.Transform(matrix)))
+            {
+                visible_meshes.push_back({&mesh, transform});
+            }
+        }
+    }
+} // Kitsune
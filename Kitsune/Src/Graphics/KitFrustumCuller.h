@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Core/KitDefinitions.h"
+#include "Core/KitJobSystem.h"
+#include "Core/Scene/KitScene.h"
+#include "KitBounds.h"
+
+namespace Kitsune
+{
+    class KitMesh;
+
+    struct KitVisibleMesh
+    {
+        const KitMesh*           mesh;
+        const KitWorldTransform* transform;
+    };
+
+    // Counted in mesh draws of the models the scene BVH did not reject as a whole
+    struct KitCullingStats
+    {
+        uint32_t tested  = 0;
+        uint32_t visible = 0;
+        uint32_t culled  = 0;
+    };
+
+    // Builds the list of meshes inside the camera frustum, once per frame after the world transforms are updated.
+    // The scene BVH rejects whole subtrees of models first and accepts subtrees fully inside without further tests.
+    // Remaining models are tested with their bounding sphere, surviving meshes with their own sphere and box.
+    // Large scenes are split into BVH subtrees culled in parallel, the result keeps the order of a single threaded pass.
+    class KitFrustumCuller
+    {
+        // Below this many objects the split and the merge cost more than they save
+        static constexpr uint32_t PARALLEL_OBJECT_COUNT = 4096;
+
+        // Enough subtrees per thread for stealing to even out unbalanced parts of the view
+        static constexpr uint32_t CHUNKS_PER_PARTICIPANT = 8;
+
+        struct KitCullingWorker
+        {
+            std::vector<KitVisibleMesh> visible_meshes;
+            KitCullingStats             stats;
+        };
+
+        // Where the meshes of a chunk ended up in the local list of the worker that culled it
+        struct KitCulledChunk
+        {
+            uint32_t worker = 0;
+            uint32_t begin  = 0;
+            uint32_t end    = 0;
+        };
+
+        std::vector<KitVisibleMesh> visible_meshes_;
+        KitCullingStats             stats_;
+
+        // Scratch reused every frame
+        std::vector<KitCullingWorker>      workers_;
+        std::vector<KitCulledChunk>        culled_chunks_;
+        std::vector<KitBvh::KitBvhSubtree> subtrees_;
+
+    public:
+        // Runs on the calling thread alone without a job system
+        void Cull(const KitScene& scene, const KitFrustum& frustum, KitJobSystem* job_system = nullptr);
+
+        // Valid until the scene changes structurally, points into the component storage
+        KIT_NODISCARD const std::vector<KitVisibleMesh>& GetVisibleMeshes() const { return visible_meshes_; }
+        KIT_NODISCARD const KitCullingStats& GetStats() const { return stats_; }
+
+    private:
+        static void CullModel(
+            const KitScene&              scene,
+            const KitFrustum&            frustum,
+            int32_t                      proxy,
+            bool                         is_inside,
+            std::vector<KitVisibleMesh>& visible_meshes,
+            KitCullingStats&             stats);
+    };
+} // Kitsune
@@ -0,0 +1,263 @@
+#include "KitGeometryArena.h"
+
+#include <algorithm>
+
+#include "KitModel.h"
+#include "KitSwapChain.h"
+#include "KitUploadManager.h"
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    KitFreeList::KitFreeList(const uint32_t capacity) :
+        capacity_(capacity)
+    {
+        if (capacity_ > 0)
+        {
+            free_ranges_.emplace(0, capacity_);
+        }
+    }
+
+    std::optional<uint32_t> KitFreeList::Allocate(const uint32_t count)
+    {
+        // Ranges are ordered by offset, so with no holes this appends after the last allocation
+        for (auto it = free_ranges_.begin(); it != free_ranges_.end(); ++it)
+        {
+            if (it->second < count)
+            {
+                continue;
+            }
+
+            const uint32_t offset    = it->first;
+            const uint32_t remaining = it->second - count;
+
+            free_ranges_.erase(it);
+            if (remaining > 0)
+            {
+                free_ranges_.emplace(offset + count, remaining);
+            }
+
+            return offset;
+        }
+
+        return std::nullopt;
+    }
+
+    void KitFreeList::Free(uint32_t offset, uint32_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        auto next = free_ranges_.lower_bound(offset);
+
+        if (next != free_ranges_.begin())
+        {
+            const auto previous = std::prev(next);
+            if (previous->first + previous->second == offset)
+            {
+                offset = previous->first;
+                count += previous->second;
+                free_ranges_.erase(previous);
+            }
+        }
+
+        if (next != free_ranges_.end() && offset + count == next->first)
+        {
+            count += next->second;
+            free_ranges_.erase(next);
+        }
+
+        free_ranges_.emplace(offset, count);
+    }
+
+    bool KitFreeList::IsEmpty() const
+    {
+        return capacity_ == 0 || (free_ranges_.size() == 1 && free_ranges_.begin()->second == capacity_);
+    }
+
+    KitGeometryArena::KitGeometryArena(KitEngineDevice* device, const uint32_t vertex_stride) :
+        device_(device),
+        vertex_stride_(vertex_stride)
+    {
+    }
+
+    KitGeometryArena::~KitGeometryArena()
+    {
+        pending_frees_.clear();
+        pages_.clear();
+    }
+
+    KitSubmeshRange KitGeometryArena::Allocate(const KitMeshView& data)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, data.vertex_count >= 3, "Vertex count must be at least 3!");
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, data.vertices.size() == static_cast<size_t>(data.vertex_count) * vertex_stride_,
+                   "Vertex data does not match the arena layout!");
+
+        const auto index_count = static_cast<uint32_t>(data.indices.size());
+
+        KitSubmeshRange range{};
+        range.index_count  = index_count;
+        range.vertex_count = data.vertex_count;
+
+        bool is_allocated = false;
+
+        for (uint32_t page_index = 0; page_index < pages_.size() && !is_allocated; page_index++)
+        {
+            KitGeometryPage* page = pages_[page_index].get();
+            if (page == nullptr || page->is_oversized)
+            {
+                continue;
+            }
+
+            const std::optional<uint32_t> vertex_offset = page->vertex_free_list.Allocate(data.vertex_count);
+            if (!vertex_offset.has_value())
+            {
+                continue;
+            }
+
+            std::optional<uint32_t> first_index = 0;
+            if (index_count > 0)
+            {
+                first_index = page->index_free_list.Allocate(index_count);
+                if (!first_index.has_value())
+                {
+                    page->vertex_free_list.Free(vertex_offset.value(), data.vertex_count);
+                    continue;
+                }
+            }
+
+            range.page          = page_index;
+            range.vertex_offset = vertex_offset.value();
+            range.first_index   = first_index.value();
+            is_allocated        = true;
+        }
+
+        if (!is_allocated)
+        {
+            const auto vertex_capacity = static_cast<uint32_t>(VERTEX_PAGE_SIZE / vertex_stride_);
+            const auto index_capacity  = static_cast<uint32_t>(INDEX_PAGE_SIZE / sizeof(uint32_t));
+
+            const bool is_oversized = data.vertex_count > vertex_capacity || index_count > index_capacity;
+
+            range.page = is_oversized
+                ? CreatePage(data.vertex_count, index_count, true)
+                : CreatePage(vertex_capacity, index_capacity, false);
+
+            KitGeometryPage& page = *pages_[range.page];
+            range.vertex_offset   = page.vertex_free_list.Allocate(data.vertex_count).value();
+            range.first_index     = index_count > 0 ? page.index_free_list.Allocate(index_count).value() : 0;
+        }
+
+        KitGeometryPage&  page           = *pages_[range.page];
+        KitUploadManager* upload_manager = device_->GetUploadManager();
+
+        upload_manager->UploadBuffer(
+            page.vertex_buffer->GetBuffer(),
+            data.vertices.data(),
+            data.vertices.size(),
+            static_cast<VkDeviceSize>(range.vertex_offset) * vertex_stride_);
+
+        if (index_count > 0)
+        {
+            upload_manager->UploadBuffer(
+                page.index_buffer->GetBuffer(),
+                data.indices.data(),
+                data.indices.size_bytes(),
+                static_cast<VkDeviceSize>(range.first_index) * sizeof(uint32_t));
+        }
+
+        return range;
+    }
+
+    void KitGeometryArena::Free(const KitSubmeshRange& range)
+    {
+        pending_frees_.push_back({range, frame_index_});
+    }
+
+    void KitGeometryArena::EndFrame()
+    {
+        frame_index_++;
+
+        std::erase_if(
+            pending_frees_,
+            [this](const KitPendingFree& pending_free)
+            {
+                if (frame_index_ - pending_free.frame <= KitSwapChain::MAX_FRAMES_IN_FLIGHT)
+                {
+                    return false;
+                }
+
+                Release(pending_free.range);
+                return true;
+            });
+    }
+
+    void KitGeometryArena::Bind(VkCommandBuffer command_buffer, const uint32_t page) const
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, page < pages_.size() && pages_[page] != nullptr, "Binding freed geometry page {}", page);
+
+        const KitGeometryPage& geometry_page = *pages_[page];
+
+        const VkBuffer     buffers[] = {geometry_page.vertex_buffer->GetBuffer()};
+        const VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(command_buffer, 0, 1, buffers, offsets);
+
+        if (geometry_page.index_buffer != nullptr)
+        {
+            vkCmdBindIndexBuffer(command_buffer, geometry_page.index_buffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+        }
+    }
+
+    uint32_t KitGeometryArena::CreatePage(const uint32_t vertex_capacity, const uint32_t index_capacity, const bool is_oversized)
+    {
+        auto page          = std::make_unique<KitGeometryPage>(vertex_capacity, index_capacity);
+        page->is_oversized = is_oversized;
+
+        page->vertex_buffer = std::make_unique<KitGraphicsBuffer>(
+            device_,
+            vertex_stride_,
+            vertex_capacity,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (index_capacity > 0)
+        {
+            page->index_buffer = std::make_unique<KitGraphicsBuffer>(
+                device_,
+                sizeof(uint32_t),
+                index_capacity,
+                VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        }
+
+        KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO, "Geometry arena (stride {}) added {}page of {} vertices / {} indices",
+                vertex_stride_, is_oversized ? "oversized " : "", vertex_capacity, index_capacity);
+
+        // Reuse a slot left by a released oversized page so existing ranges keep their page index
+        const auto free_slot = std::ranges::find_if(pages_, [](const std::unique_ptr<KitGeometryPage>& slot) { return slot == nullptr; });
+        if (free_slot != pages_.end())
+        {
+            *free_slot = std::move(page);
+            return static_cast<uint32_t>(free_slot - pages_.begin());
+        }
+
+        pages_.push_back(std::move(page));
+        return static_cast<uint32_t>(pages_.size() - 1);
+    }
+
+    void KitGeometryArena::Release(const KitSubmeshRange& range)
+    {
+        KitGeometryPage& page = *pages_[range.page];
+
+        page.vertex_free_list.Free(range.vertex_offset, range.vertex_count);
+        page.index_free_list.Free(range.first_index, range.index_count);
+
+        // Regular pages stay around for the next load, oversized ones only ever fit the mesh they were made for
+        if (page.is_oversized && page.vertex_free_list.IsEmpty() && page.index_free_list.IsEmpty())
+        {
+            pages_[range.page].reset();
+        }
+    }
+} // namespace Kitsune
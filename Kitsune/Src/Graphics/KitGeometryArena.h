@@ -0,0 +1,106 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "KitGraphicsBuffer.h"
+#include "Core/KitDefinitions.h"
+
+namespace Kitsune
+{
+    struct KitMeshView;
+
+    // First fit over [0, capacity) elements, freed ranges are merged with their neighbours
+    class KitFreeList
+    {
+        std::map<uint32_t, uint32_t> free_ranges_; // Offset -> count
+        uint32_t                     capacity_ = 0;
+
+    public:
+        explicit KitFreeList(uint32_t capacity);
+
+        std::optional<uint32_t> Allocate(uint32_t count);
+        void Free(uint32_t offset, uint32_t count);
+
+        KIT_NODISCARD bool IsEmpty() const;
+        KIT_NODISCARD uint32_t GetCapacity() const { return capacity_; }
+    };
+
+    // Where a mesh lives inside a geometry arena
+    struct KitSubmeshRange
+    {
+        uint32_t page          = 0;
+        uint32_t first_index   = 0;
+        uint32_t index_count   = 0;
+        uint32_t vertex_offset = 0;
+        uint32_t vertex_count  = 0;
+    };
+
+    // Packs the meshes of one vertex layout into a few large shared vertex and index buffers,
+    // so one bind serves every mesh in the same page. Main thread only.
+    class KitGeometryArena final
+    {
+        struct KitGeometryPage
+        {
+            std::unique_ptr<KitGraphicsBuffer> vertex_buffer;
+            std::unique_ptr<KitGraphicsBuffer> index_buffer;
+
+            KitFreeList vertex_free_list;
+            KitFreeList index_free_list;
+
+            bool is_oversized = false; // Sized for a single mesh that does not fit a regular page
+
+            KitGeometryPage(uint32_t vertex_capacity, uint32_t index_capacity) :
+                vertex_free_list(vertex_capacity),
+                index_free_list(index_capacity)
+            {
+            }
+        };
+
+        struct KitPendingFree
+        {
+            KitSubmeshRange range;
+            uint64_t        frame;
+        };
+
+        KitEngineDevice* device_;
+        uint32_t         vertex_stride_;
+
+        std::vector<std::unique_ptr<KitGeometryPage>> pages_; // Null slots are released oversized pages
+
+        // Freed ranges may still be read by frames in flight
+        std::vector<KitPendingFree> pending_frees_;
+        uint64_t                    frame_index_ = 0;
+
+    public:
+        static constexpr VkDeviceSize VERTEX_PAGE_SIZE = 32ull * 1024 * 1024;
+        static constexpr VkDeviceSize INDEX_PAGE_SIZE  = 16ull * 1024 * 1024;
+
+        KitGeometryArena(KitEngineDevice* device, uint32_t vertex_stride);
+        ~KitGeometryArena();
+
+        KitGeometryArena(const KitGeometryArena&)            = delete;
+        KitGeometryArena& operator=(const KitGeometryArena&) = delete;
+
+        // Finds room for the mesh, appending a page if needed, and queues its upload
+        KitSubmeshRange Allocate(const KitMeshView& data);
+
+        // The range is reused once the frames that may still draw it have completed
+        void Free(const KitSubmeshRange& range);
+
+        // Called once per submitted frame, releases frees that no frame in flight can see anymore
+        void EndFrame();
+
+        void Bind(VkCommandBuffer command_buffer, uint32_t page) const;
+
+        KIT_NODISCARD uint32_t GetVertexStride() const { return vertex_stride_; }
+        KIT_NODISCARD size_t GetPageCount() const { return pages_.size(); }
+
+    private:
+        uint32_t CreatePage(uint32_t vertex_capacity, uint32_t index_capacity, bool is_oversized);
+        void Release(const KitSubmeshRange& range);
+    };
+} // namespace Kitsune
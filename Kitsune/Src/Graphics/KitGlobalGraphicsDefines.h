@@ -3,12 +3,28 @@
 
 namespace Kitsune
 {
-#define MAX_LIGHTS 10
+#define MAX_LIGHTS 1024
+
+// View space cluster grid, must match the constants in Simple3DFrag.glsl
+#define CLUSTER_COUNT_X 16
+#define CLUSTER_COUNT_Y 9
+#define CLUSTER_COUNT_Z 24
+#define CLUSTER_COUNT (CLUSTER_COUNT_X * CLUSTER_COUNT_Y * CLUSTER_COUNT_Z)
+
+// Capacity of the light index list shared by all clusters
+#define MAX_CLUSTER_LIGHT_INDICES (CLUSTER_COUNT * 64)
 
     struct PointLightData
     {
-        glm::vec4 position;
-        glm::vec4 color;
+        glm::vec4 position; // w is the range past which the light is ignored
+        glm::vec4 color;    // w is intensity
+    };
+
+    // Offset and count of a cluster's lights in the light index list
+    struct ClusterData
+    {
+        uint32_t offset;
+        uint32_t count;
     };
 
     struct KitGlobalUBO
@@ -19,9 +35,11 @@ namespace Kitsune
         alignas(16) glm::vec3 light_direction = glm::normalize(glm::vec3(1.f, -3.f, -1.f));
         float                 padding1;
 
-        alignas(16) glm::vec4      ambient_color = glm::vec4(1.f, 1.f, 1.f, .02f);
-        alignas(16) PointLightData point_lights[MAX_LIGHTS];
-        alignas(16) int            num_lights;
-        float                      padding2[3];
+        alignas(16) glm::vec4 ambient_color = glm::vec4(1.f, 1.f, 1.f, .02f);
+
+        // xy turn a fragment coordinate into a tile, zw turn the log of the view depth into a slice
+        alignas(16) glm::vec4 cluster_scale{0.f};
+        alignas(16) int       num_lights;
+        float                 padding2[3];
     };
 }
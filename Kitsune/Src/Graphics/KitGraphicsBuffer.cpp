@@ -1,5 +1,7 @@
 #include "KitGraphicsBuffer.h"
 
+#include <algorithm>
+
 #include "Core/KitLogs.h"
 
 namespace Kitsune
@@ -20,29 +22,28 @@ namespace Kitsune
     {
         alignment_size_ = GetAlignment(instance_size_, min_offset_alignment_);
         buffer_size_    = alignment_size_ * instance_count_;
-        device->CreateBuffer(buffer_size_, usage_flags_, memory_property_flags_, buffer_, memory_);
+        device->CreateBuffer(buffer_size_, usage_flags_, memory_property_flags_, buffer_, allocation_);
     }
 
     KitGraphicsBuffer::~KitGraphicsBuffer()
     {
         Unmap();
-        vkDestroyBuffer(device_->GetDevice(), buffer_, nullptr);
-        vkFreeMemory(device_->GetDevice(), memory_, nullptr);
+        device_->DestroyBuffer(buffer_, allocation_);
     }
 
     VkResult KitGraphicsBuffer::Map(const VkDeviceSize size, const VkDeviceSize offset)
     {
-        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, buffer_ && memory_, "Called map on buffer before create");
-        return vkMapMemory(device_->GetDevice(), memory_, offset, size, 0, &mapped_);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, buffer_ && allocation_.IsValid(), "Called map on buffer before create");
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, allocation_.mapped, "Called map on buffer that is not host visible");
+
+        // Host visible blocks stay mapped for their whole lifetime, mapping just hands out the pointer
+        mapped_ = static_cast<char*>(allocation_.mapped) + offset;
+        return VK_SUCCESS;
     }
 
     void KitGraphicsBuffer::Unmap()
     {
-        if (mapped_)
-        {
-            vkUnmapMemory(device_->GetDevice(), memory_);
-            mapped_ = nullptr;
-        }
+        mapped_ = nullptr;
     }
 
     void KitGraphicsBuffer::WriteToBuffer(const void* data, const VkDeviceSize size, const VkDeviceSize offset) const
@@ -63,13 +64,7 @@ namespace Kitsune
 
     VkResult KitGraphicsBuffer::Flush(const VkDeviceSize size, const VkDeviceSize offset) const
     {
-        VkMappedMemoryRange mapped_range = {};
-        mapped_range.sType               = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mapped_range.memory              = memory_;
-        mapped_range.offset              = offset;
-        mapped_range.size                = size;
-
-        return vkFlushMappedMemoryRanges(device_->GetDevice(), 1, &mapped_range);
+        return device_->GetMemoryAllocator()->Flush(allocation_, size, offset);
     }
 
     VkDescriptorBufferInfo KitGraphicsBuffer::DescriptorInfo(const VkDeviceSize size, const VkDeviceSize offset) const
@@ -83,12 +78,7 @@ namespace Kitsune
 
     VkResult KitGraphicsBuffer::Invalidate(const VkDeviceSize size, const VkDeviceSize offset) const
     {
-        VkMappedMemoryRange mapped_range = {};
-        mapped_range.sType               = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
-        mapped_range.memory              = memory_;
-        mapped_range.offset              = offset;
-        mapped_range.size                = size;
-        return vkInvalidateMappedMemoryRanges(device_->GetDevice(), 1, &mapped_range);
+        return device_->GetMemoryAllocator()->Invalidate(allocation_, size, offset);
     }
 
     void KitGraphicsBuffer::WriteToIndex(const void* data, const int index) const
@@ -120,4 +110,34 @@ namespace Kitsune
 
         return instance_size;
     }
+
+    std::unique_ptr<KitGraphicsBuffer> KitGraphicsBuffer::Reserve(
+        KitEngineDevice*                    device,
+        std::unique_ptr<KitGraphicsBuffer>& buffer,
+        const VkDeviceSize                  instance_size,
+        const uint32_t                      instance_count,
+        const VkBufferUsageFlags            usage_flags,
+        const VkMemoryPropertyFlags         memory_property_flags)
+    {
+        if (buffer != nullptr && buffer->GetInstanceCount() >= instance_count)
+        {
+            return nullptr;
+        }
+
+        uint32_t capacity = buffer != nullptr ? std::max(buffer->GetInstanceCount(), 1u) : 1;
+        while (capacity < instance_count)
+        {
+            capacity *= 2;
+        }
+
+        std::unique_ptr<KitGraphicsBuffer> old_buffer = std::move(buffer);
+        buffer = std::make_unique<KitGraphicsBuffer>(device, instance_size, capacity, usage_flags, memory_property_flags);
+
+        if (memory_property_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        {
+            buffer->Map();
+        }
+
+        return old_buffer;
+    }
 } // namespace Kitsune
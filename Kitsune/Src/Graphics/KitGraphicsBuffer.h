@@ -1,4 +1,6 @@
 #pragma once
+#include <memory>
+
 #include "KitEngineDevice.h"
 
 namespace Kitsune
@@ -8,7 +10,7 @@ namespace Kitsune
         KitEngineDevice* device_ = nullptr;
         void*            mapped_ = nullptr;
         VkBuffer         buffer_ = VK_NULL_HANDLE;
-        VkDeviceMemory   memory_ = VK_NULL_HANDLE;
+        KitAllocation    allocation_{};
 
         VkDeviceSize          buffer_size_           = 0;
         uint32_t              instance_count_        = 0;
@@ -53,6 +55,17 @@ namespace Kitsune
         VkDescriptorBufferInfo DescriptorInfoForIndex(const int index) const;
         VkResult               InvalidateIndex(const int index) const;
 
+        // Recreates buffer once it holds fewer than instance_count instances, doubling its capacity so slowly growing
+        // contents do not reallocate every frame. Host visible buffers come back mapped. Returns the replaced buffer,
+        // which may still be read by frames in flight, or null when no growth was needed.
+        static std::unique_ptr<KitGraphicsBuffer> Reserve(
+            KitEngineDevice*                    device,
+            std::unique_ptr<KitGraphicsBuffer>& buffer,
+            const VkDeviceSize                  instance_size,
+            const uint32_t                      instance_count,
+            const VkBufferUsageFlags            usage_flags,
+            const VkMemoryPropertyFlags         memory_property_flags);
+
     private:
         static VkDeviceSize GetAlignment(const VkDeviceSize instance_size, const VkDeviceSize min_offset_alignment);
     };
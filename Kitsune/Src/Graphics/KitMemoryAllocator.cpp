@@ -0,0 +1,372 @@
+#include "KitMemoryAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <set>
+
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    struct KitMemoryBlock
+    {
+        VkDeviceMemory memory           = VK_NULL_HANDLE;
+        VkDeviceSize   size             = 0;
+        uint8_t*       mapped           = nullptr;
+        uint32_t       allocation_count = 0;
+
+        // Offsets of free nodes per level, level 0 is the whole block and every level halves the node size
+        std::vector<std::set<VkDeviceSize>> free_lists;
+
+        KIT_NODISCARD VkDeviceSize GetNodeSize(const uint32_t level) const { return size >> level; }
+    };
+
+    KitMemoryAllocator::KitMemoryAllocator(const VkPhysicalDevice physical_device, const VkDevice logical_device) :
+        logical_device_(logical_device)
+    {
+        vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties_);
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physical_device, &properties);
+        non_coherent_atom_size_ = std::max<VkDeviceSize>(properties.limits.nonCoherentAtomSize, 1);
+
+        pools_.resize(memory_properties_.memoryTypeCount * static_cast<uint32_t>(KitMemoryTiling::COUNT));
+
+        // Small heaps (integrated or BAR memory) get smaller blocks so one block can not eat the heap
+        for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; i++)
+        {
+            const VkDeviceSize heap_size = memory_properties_.memoryHeaps[memory_properties_.memoryTypes[i].heapIndex].size;
+            const VkDeviceSize limit     = std::max<VkDeviceSize>(std::bit_floor(heap_size / 8), MIN_NODE_SIZE);
+
+            block_sizes_[i] = std::min(DEFAULT_BLOCK_SIZE, limit);
+        }
+    }
+
+    KitMemoryAllocator::~KitMemoryAllocator()
+    {
+        for (uint32_t heap = 0; heap < memory_properties_.memoryHeapCount; heap++)
+        {
+            if (heap_stats_[heap].allocation_count > 0)
+            {
+                KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_WARNING, "Memory heap {} still has {} live allocations",
+                        heap, heap_stats_[heap].allocation_count);
+            }
+        }
+
+        for (uint32_t memory_type = 0; memory_type < memory_properties_.memoryTypeCount; memory_type++)
+        {
+            for (uint32_t tiling = 0; tiling < static_cast<uint32_t>(KitMemoryTiling::COUNT); tiling++)
+            {
+                for (const std::unique_ptr<KitMemoryBlock>& block : GetPool(memory_type, static_cast<KitMemoryTiling>(tiling)).blocks)
+                {
+                    DestroyBlock(*block, memory_type);
+                }
+            }
+        }
+    }
+
+    KitAllocation KitMemoryAllocator::Allocate(const VkMemoryRequirements& requirements, const uint32_t memory_type, const KitMemoryTiling tiling)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, memory_type < memory_properties_.memoryTypeCount, "Invalid memory type {}", memory_type);
+
+        std::lock_guard lock(mutex_);
+
+        // Buddy nodes are aligned to their own size, so rounding up to the alignment satisfies it too
+        const VkDeviceSize node_size  = std::bit_ceil(std::max({requirements.size, requirements.alignment, MIN_NODE_SIZE}));
+        const VkDeviceSize block_size = block_sizes_[memory_type];
+
+        if (node_size > block_size / 2)
+        {
+            return AllocateDedicated(requirements, memory_type, tiling);
+        }
+
+        const auto target_level = static_cast<uint32_t>(std::countr_zero(block_size) - std::countr_zero(node_size));
+
+        KitMemoryPool&  pool       = GetPool(memory_type, tiling);
+        KitMemoryBlock* block      = nullptr;
+        uint32_t        free_level = 0;
+
+        for (const std::unique_ptr<KitMemoryBlock>& candidate : pool.blocks)
+        {
+            // Smallest free node that still fits
+            for (uint32_t level = target_level + 1; level-- > 0;)
+            {
+                if (!candidate->free_lists[level].empty())
+                {
+                    block      = candidate.get();
+                    free_level = level;
+                    break;
+                }
+            }
+
+            if (block != nullptr)
+            {
+                break;
+            }
+        }
+
+        if (block == nullptr)
+        {
+            block      = pool.blocks.emplace_back(CreateBlock(memory_type)).get();
+            free_level = 0;
+        }
+
+        // Take the lowest free node and split it down to the requested size
+        const VkDeviceSize offset = *block->free_lists[free_level].begin();
+        block->free_lists[free_level].erase(block->free_lists[free_level].begin());
+
+        for (uint32_t level = free_level + 1; level <= target_level; level++)
+        {
+            block->free_lists[level].insert(offset + block->GetNodeSize(level));
+        }
+
+        block->allocation_count++;
+
+        KitMemoryHeapStats& stats = heap_stats_[memory_properties_.memoryTypes[memory_type].heapIndex];
+        stats.allocation_count++;
+        stats.allocated_bytes += node_size;
+        stats.requested_bytes += requirements.size;
+
+        KitAllocation allocation{};
+        allocation.memory      = block->memory;
+        allocation.offset      = offset;
+        allocation.size        = requirements.size;
+        allocation.mapped      = block->mapped != nullptr ? block->mapped + offset : nullptr;
+        allocation.memory_type = memory_type;
+        allocation.tiling      = tiling;
+        allocation.block       = block;
+        allocation.level       = target_level;
+
+        return allocation;
+    }
+
+    void KitMemoryAllocator::Free(KitAllocation& allocation)
+    {
+        if (!allocation.IsValid())
+        {
+            return;
+        }
+
+        std::lock_guard lock(mutex_);
+
+        KitMemoryHeapStats& stats = heap_stats_[memory_properties_.memoryTypes[allocation.memory_type].heapIndex];
+        stats.allocation_count--;
+        stats.requested_bytes -= allocation.size;
+
+        if (allocation.block == nullptr)
+        {
+            if (allocation.mapped != nullptr)
+            {
+                vkUnmapMemory(logical_device_, allocation.memory);
+            }
+
+            vkFreeMemory(logical_device_, allocation.memory, nullptr);
+
+            stats.dedicated_count--;
+            stats.reserved_bytes  -= allocation.size;
+            stats.allocated_bytes -= allocation.size;
+
+            allocation = KitAllocation{};
+            return;
+        }
+
+        KitMemoryBlock& block = *allocation.block;
+        stats.allocated_bytes -= block.GetNodeSize(allocation.level);
+
+        // Merge with the buddy for as long as it is free
+        VkDeviceSize offset = allocation.offset;
+        uint32_t     level  = allocation.level;
+
+        while (level > 0)
+        {
+            const VkDeviceSize buddy = offset ^ block.GetNodeSize(level);
+            const auto         it    = block.free_lists[level].find(buddy);
+            if (it == block.free_lists[level].end())
+            {
+                break;
+            }
+
+            block.free_lists[level].erase(it);
+            offset = std::min(offset, buddy);
+            level--;
+        }
+
+        block.free_lists[level].insert(offset);
+        block.allocation_count--;
+
+        // Keep one empty block around per pool so a load/unload cycle does not hit the driver every time
+        KitMemoryPool& pool = GetPool(allocation.memory_type, allocation.tiling);
+        if (block.allocation_count == 0 && pool.blocks.size() > 1)
+        {
+            DestroyBlock(block, allocation.memory_type);
+            std::erase_if(pool.blocks, [&block](const std::unique_ptr<KitMemoryBlock>& candidate) { return candidate.get() == &block; });
+        }
+
+        allocation = KitAllocation{};
+    }
+
+    VkResult KitMemoryAllocator::Flush(const KitAllocation& allocation, const VkDeviceSize size, const VkDeviceSize offset) const
+    {
+        if (IsCoherent(allocation.memory_type))
+        {
+            return VK_SUCCESS;
+        }
+
+        const VkMappedMemoryRange range = GetMappedRange(allocation, size, offset);
+        return vkFlushMappedMemoryRanges(logical_device_, 1, &range);
+    }
+
+    VkResult KitMemoryAllocator::Invalidate(const KitAllocation& allocation, const VkDeviceSize size, const VkDeviceSize offset) const
+    {
+        if (IsCoherent(allocation.memory_type))
+        {
+            return VK_SUCCESS;
+        }
+
+        const VkMappedMemoryRange range = GetMappedRange(allocation, size, offset);
+        return vkInvalidateMappedMemoryRanges(logical_device_, 1, &range);
+    }
+
+    KitMemoryHeapStats KitMemoryAllocator::GetHeapStats(const uint32_t heap_index) const
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, heap_index < memory_properties_.memoryHeapCount, "Invalid memory heap {}", heap_index);
+
+        std::lock_guard lock(mutex_);
+        return heap_stats_[heap_index];
+    }
+
+    void KitMemoryAllocator::LogStats() const
+    {
+        std::lock_guard lock(mutex_);
+
+        for (uint32_t heap = 0; heap < memory_properties_.memoryHeapCount; heap++)
+        {
+            const KitMemoryHeapStats& stats = heap_stats_[heap];
+            if (stats.block_count == 0 && stats.dedicated_count == 0)
+            {
+                continue;
+            }
+
+            constexpr double MB = 1024.0 * 1024.0;
+            KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO,
+                    "Memory heap {}: {} allocations in {} blocks + {} dedicated, {:.1f} MB reserved, {:.1f} MB allocated, {:.1f} MB requested",
+                    heap, stats.allocation_count, stats.block_count, stats.dedicated_count,
+                    stats.reserved_bytes / MB, stats.allocated_bytes / MB, stats.requested_bytes / MB);
+        }
+    }
+
+    KitAllocation KitMemoryAllocator::AllocateDedicated(const VkMemoryRequirements& requirements, const uint32_t memory_type, const KitMemoryTiling tiling)
+    {
+        VkMemoryAllocateInfo alloc_info{};
+        alloc_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize  = requirements.size;
+        alloc_info.memoryTypeIndex = memory_type;
+
+        KitAllocation allocation{};
+        allocation.size        = requirements.size;
+        allocation.memory_type = memory_type;
+        allocation.tiling      = tiling;
+
+        VkResult result = vkAllocateMemory(logical_device_, &alloc_info, nullptr, &allocation.memory);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to allocate {} bytes of dedicated memory!", requirements.size);
+
+        if (IsHostVisible(memory_type))
+        {
+            result = vkMapMemory(logical_device_, allocation.memory, 0, VK_WHOLE_SIZE, 0, &allocation.mapped);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to map dedicated memory!");
+        }
+
+        KitMemoryHeapStats& stats = heap_stats_[memory_properties_.memoryTypes[memory_type].heapIndex];
+        stats.dedicated_count++;
+        stats.allocation_count++;
+        stats.reserved_bytes  += requirements.size;
+        stats.allocated_bytes += requirements.size;
+        stats.requested_bytes += requirements.size;
+
+        return allocation;
+    }
+
+    std::unique_ptr<KitMemoryBlock> KitMemoryAllocator::CreateBlock(const uint32_t memory_type)
+    {
+        auto block  = std::make_unique<KitMemoryBlock>();
+        block->size = block_sizes_[memory_type];
+
+        VkMemoryAllocateInfo alloc_info{};
+        alloc_info.sType           = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        alloc_info.allocationSize  = block->size;
+        alloc_info.memoryTypeIndex = memory_type;
+
+        VkResult result = vkAllocateMemory(logical_device_, &alloc_info, nullptr, &block->memory);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to allocate memory block of memory type {}!", memory_type);
+
+        if (IsHostVisible(memory_type))
+        {
+            void* mapped = nullptr;
+            result = vkMapMemory(logical_device_, block->memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to map memory block!");
+
+            block->mapped = static_cast<uint8_t*>(mapped);
+        }
+
+        const auto level_count = static_cast<uint32_t>(std::countr_zero(block->size) - std::countr_zero(MIN_NODE_SIZE)) + 1;
+        block->free_lists.resize(level_count);
+        block->free_lists[0].insert(0);
+
+        KitMemoryHeapStats& stats = heap_stats_[memory_properties_.memoryTypes[memory_type].heapIndex];
+        stats.block_count++;
+        stats.reserved_bytes += block->size;
+
+        return block;
+    }
+
+    void KitMemoryAllocator::DestroyBlock(KitMemoryBlock& block, const uint32_t memory_type)
+    {
+        if (block.mapped != nullptr)
+        {
+            vkUnmapMemory(logical_device_, block.memory);
+        }
+
+        vkFreeMemory(logical_device_, block.memory, nullptr);
+
+        KitMemoryHeapStats& stats = heap_stats_[memory_properties_.memoryTypes[memory_type].heapIndex];
+        stats.block_count--;
+        stats.reserved_bytes -= block.size;
+    }
+
+    VkMappedMemoryRange KitMemoryAllocator::GetMappedRange(const KitAllocation& allocation, const VkDeviceSize size, const VkDeviceSize offset) const
+    {
+        // A buddy node always spans whole atoms since nonCoherentAtomSize is at most MIN_NODE_SIZE
+        const VkDeviceSize reserved = allocation.block != nullptr ? allocation.block->GetNodeSize(allocation.level) : allocation.size;
+        const VkDeviceSize end      = size == VK_WHOLE_SIZE ? reserved : std::min(offset + size, reserved);
+
+        const VkDeviceSize aligned_begin = (allocation.offset + offset) / non_coherent_atom_size_ * non_coherent_atom_size_;
+        VkDeviceSize       aligned_end   = (allocation.offset + end + non_coherent_atom_size_ - 1) / non_coherent_atom_size_ * non_coherent_atom_size_;
+
+        VkMappedMemoryRange range{};
+        range.sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+        range.memory = allocation.memory;
+        range.offset = aligned_begin;
+
+        // Dedicated allocations are not padded to the atom size, the tail has to be flushed as VK_WHOLE_SIZE
+        if (allocation.block == nullptr && aligned_end > allocation.size)
+        {
+            range.size = VK_WHOLE_SIZE;
+        }
+        else
+        {
+            range.size = aligned_end - aligned_begin;
+        }
+
+        return range;
+    }
+
+    bool KitMemoryAllocator::IsHostVisible(const uint32_t memory_type) const
+    {
+        return (memory_properties_.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+    }
+
+    bool KitMemoryAllocator::IsCoherent(const uint32_t memory_type) const
+    {
+        return (memory_properties_.memoryTypes[memory_type].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+    }
+} // namespace Kitsune
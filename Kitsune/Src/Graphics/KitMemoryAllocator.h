@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "Core/KitDefinitions.h"
+
+namespace Kitsune
+{
+    // Buffers and linear images never share a block with optimal tiling images,
+    // so neighbouring allocations never have to be padded for bufferImageGranularity
+    enum class KitMemoryTiling : uint32_t
+    {
+        LINEAR,
+        OPTIMAL,
+        COUNT
+    };
+
+    struct KitMemoryBlock;
+
+    // A range of device memory handed out by KitMemoryAllocator
+    struct KitAllocation
+    {
+        VkDeviceMemory  memory      = VK_NULL_HANDLE;
+        VkDeviceSize    offset      = 0;
+        VkDeviceSize    size        = 0;
+        void*           mapped      = nullptr; // Points at offset, stays valid for the allocation's lifetime on host visible memory
+        uint32_t        memory_type = 0;
+        KitMemoryTiling tiling      = KitMemoryTiling::LINEAR;
+        KitMemoryBlock* block       = nullptr; // Null for dedicated allocations
+        uint32_t        level       = 0;       // Buddy level inside the block, level 0 spans the whole block
+
+        KIT_NODISCARD bool IsValid() const { return memory != VK_NULL_HANDLE; }
+    };
+
+    struct KitMemoryHeapStats
+    {
+        uint32_t     block_count      = 0;
+        uint32_t     dedicated_count  = 0;
+        uint32_t     allocation_count = 0;
+        VkDeviceSize reserved_bytes   = 0; // Everything obtained from vkAllocateMemory
+        VkDeviceSize allocated_bytes  = 0; // Handed out to resources, including power of two rounding
+        VkDeviceSize requested_bytes  = 0; // What the resources actually asked for
+    };
+
+    // Sub-allocates resources from large per memory type blocks with a buddy allocator.
+    // Host visible blocks are mapped once for their whole lifetime. Thread safe.
+    class KitMemoryAllocator final
+    {
+        struct KitMemoryPool
+        {
+            std::vector<std::unique_ptr<KitMemoryBlock>> blocks;
+        };
+
+        VkDevice logical_device_;
+
+        VkPhysicalDeviceMemoryProperties memory_properties_{};
+        VkDeviceSize                     non_coherent_atom_size_ = 1;
+
+        std::array<VkDeviceSize, VK_MAX_MEMORY_TYPES> block_sizes_{};
+        std::vector<KitMemoryPool>                    pools_;
+
+        std::array<KitMemoryHeapStats, VK_MAX_MEMORY_HEAPS> heap_stats_{};
+
+        mutable std::mutex mutex_;
+
+    public:
+        static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64ull * 1024 * 1024;
+        static constexpr VkDeviceSize MIN_NODE_SIZE      = 256;
+
+        KitMemoryAllocator(VkPhysicalDevice physical_device, VkDevice logical_device);
+        ~KitMemoryAllocator();
+
+        KitMemoryAllocator(const KitMemoryAllocator&)            = delete;
+        KitMemoryAllocator& operator=(const KitMemoryAllocator&) = delete;
+
+        KitAllocation Allocate(const VkMemoryRequirements& requirements, uint32_t memory_type, KitMemoryTiling tiling);
+        void Free(KitAllocation& allocation);
+
+        // Offsets are relative to the allocation. No-ops on coherent memory, otherwise expanded to nonCoherentAtomSize.
+        VkResult Flush(const KitAllocation& allocation, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0) const;
+        VkResult Invalidate(const KitAllocation& allocation, VkDeviceSize size = VK_WHOLE_SIZE, VkDeviceSize offset = 0) const;
+
+        KIT_NODISCARD KitMemoryHeapStats GetHeapStats(uint32_t heap_index) const;
+        KIT_NODISCARD uint32_t GetHeapCount() const { return memory_properties_.memoryHeapCount; }
+        void LogStats() const;
+
+    private:
+        KitAllocation AllocateDedicated(const VkMemoryRequirements& requirements, uint32_t memory_type, KitMemoryTiling tiling);
+        std::unique_ptr<KitMemoryBlock> CreateBlock(uint32_t memory_type);
+        void DestroyBlock(KitMemoryBlock& block, uint32_t memory_type);
+
+        VkMappedMemoryRange GetMappedRange(const KitAllocation& allocation, VkDeviceSize size, VkDeviceSize offset) const;
+        bool IsHostVisible(uint32_t memory_type) const;
+        bool IsCoherent(uint32_t memory_type) const;
+
+        KitMemoryPool& GetPool(const uint32_t memory_type, const KitMemoryTiling tiling)
+        {
+            return pools_[memory_type * static_cast<uint32_t>(KitMemoryTiling::COUNT) + static_cast<uint32_t>(tiling)];
+        }
+    };
+} // namespace Kitsune
@@ -0,0 +1,320 @@
+#include "KitMeshOptimizer.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+#include "Core/KitLogs.h"
+#include "Core/KitUtil.h"
+
+namespace Kitsune
+{
+    namespace
+    {
+        constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+        // Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+        constexpr int   FORSYTH_CACHE_SIZE        = 32;
+        constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+        constexpr float FORSYTH_LAST_TRI_SCORE    = 0.75f;
+        constexpr float FORSYTH_VALENCE_SCALE     = 2.0f;
+        constexpr float FORSYTH_VALENCE_POWER     = 0.5f;
+
+        struct KitVertexHasher
+        {
+            size_t operator()(const KitVertex& vertex) const
+            {
+                return static_cast<size_t>(KitUtil::HashBytes(&vertex, sizeof(KitVertex)));
+            }
+        };
+
+        struct KitVertexEqual
+        {
+            bool operator()(const KitVertex& lhs, const KitVertex& rhs) const
+            {
+                return std::memcmp(&lhs, &rhs, sizeof(KitVertex)) == 0;
+            }
+        };
+
+        float ForsythVertexScore(const int cache_position, const uint32_t remaining_valence)
+        {
+            // Nothing left to draw with this vertex
+            if (remaining_valence == 0)
+            {
+                return -1.f;
+            }
+
+            float score = 0.f;
+
+            if (cache_position >= 0)
+            {
+                // The last triangle's vertices get a fixed score so the next pick does not just reuse its edge
+                if (cache_position < 3)
+                {
+                    score = FORSYTH_LAST_TRI_SCORE;
+                }
+                else
+                {
+                    const float scaler = 1.f / static_cast<float>(FORSYTH_CACHE_SIZE - 3);
+                    score = std::pow(1.f - static_cast<float>(cache_position - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+                }
+            }
+
+            // Favour vertices with few triangles left so they do not end up as lone stragglers
+            score += FORSYTH_VALENCE_SCALE * std::pow(static_cast<float>(remaining_valence), -FORSYTH_VALENCE_POWER);
+
+            return score;
+        }
+    }
+
+    KitMeshOptimizeStats KitMeshOptimizer::Optimize(KitMeshData& mesh)
+    {
+        KitMeshOptimizeStats stats{};
+        stats.vertex_count_before = mesh.vertices.size();
+
+        WeldVertices(mesh);
+
+        // Measure after welding, unwelded meshes have no reuse to speak of and would skew the comparison
+        stats.acmr_before = CalculateAcmr(mesh.indices, mesh.vertices.size());
+
+        mesh.indices = OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+        OptimizeVertexFetch(mesh);
+
+        stats.vertex_count_after = mesh.vertices.size();
+        stats.acmr_after         = CalculateAcmr(mesh.indices, mesh.vertices.size());
+
+        return stats;
+    }
+
+    void KitMeshOptimizer::WeldVertices(KitMeshData& mesh)
+    {
+        if (mesh.indices.empty())
+        {
+            mesh.indices.resize(mesh.vertices.size());
+            std::iota(mesh.indices.begin(), mesh.indices.end(), 0u);
+        }
+
+        std::unordered_map<KitVertex, uint32_t, KitVertexHasher, KitVertexEqual> unique_vertices;
+        unique_vertices.reserve(mesh.vertices.size());
+
+        std::vector<KitVertex> welded_vertices;
+        welded_vertices.reserve(mesh.vertices.size());
+
+        std::vector<uint32_t> remap(mesh.vertices.size());
+        for (size_t i = 0; i < mesh.vertices.size(); i++)
+        {
+            const auto [it, is_inserted] = unique_vertices.try_emplace(mesh.vertices[i], static_cast<uint32_t>(welded_vertices.size()));
+            if (is_inserted)
+            {
+                welded_vertices.push_back(mesh.vertices[i]);
+            }
+
+            remap[i] = it->second;
+        }
+
+        for (uint32_t& index : mesh.indices)
+        {
+            index = remap[index];
+        }
+
+        mesh.vertices = std::move(welded_vertices);
+    }
+
+    std::vector<uint32_t> KitMeshOptimizer::OptimizeVertexCache(const std::span<const uint32_t> indices, const size_t vertex_count)
+    {
+        // Leftover indices would be given a triangle past the end, such lists are kept in their original order
+        if (indices.size() % 3 != 0)
+        {
+            KIT_LOG(LOG_ENGINE, KitLogLevel::LOG_WARNING,
+                    "Index count {} is not a multiple of 3, skipping vertex cache optimization", indices.size());
+            return {indices.begin(), indices.end()};
+        }
+
+        const size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0)
+        {
+            return {indices.begin(), indices.end()};
+        }
+
+        // Triangles adjacent to each vertex, packed by vertex. The first remaining_valence entries are the undrawn ones.
+        std::vector<uint32_t> remaining_valence(vertex_count, 0);
+        for (const uint32_t index : indices)
+        {
+            remaining_valence[index]++;
+        }
+
+        std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+        std::partial_sum(remaining_valence.begin(), remaining_valence.end(), adjacency_offsets.begin() + 1);
+
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill_counts(vertex_count, 0);
+            for (size_t i = 0; i < indices.size(); i++)
+            {
+                const uint32_t vertex = indices[i];
+                adjacency[adjacency_offsets[vertex] + fill_counts[vertex]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<float> vertex_scores(vertex_count);
+        for (size_t i = 0; i < vertex_count; i++)
+        {
+            vertex_scores[i] = ForsythVertexScore(-1, remaining_valence[i]);
+        }
+
+        std::vector<float> triangle_scores(triangle_count);
+        std::vector<bool>  is_triangle_emitted(triangle_count, false);
+
+        uint32_t best_triangle = 0;
+        for (size_t i = 0; i < triangle_count; i++)
+        {
+            triangle_scores[i] = vertex_scores[indices[i * 3]] + vertex_scores[indices[i * 3 + 1]] + vertex_scores[indices[i * 3 + 2]];
+            if (triangle_scores[i] > triangle_scores[best_triangle])
+            {
+                best_triangle = static_cast<uint32_t>(i);
+            }
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(triangle_count * 3);
+
+        std::vector<uint32_t> cache;
+        std::vector<uint32_t> next_cache;
+        cache.reserve(FORSYTH_CACHE_SIZE + 3);
+        next_cache.reserve(FORSYTH_CACHE_SIZE + 3);
+
+        size_t scan_cursor = 0;
+
+        for (size_t emitted = 0; emitted < triangle_count; emitted++)
+        {
+            // Nothing in the cache has triangles left, fall back to the next undrawn triangle in input order
+            if (best_triangle == INVALID_INDEX)
+            {
+                while (is_triangle_emitted[scan_cursor])
+                {
+                    scan_cursor++;
+                }
+                best_triangle = static_cast<uint32_t>(scan_cursor);
+            }
+
+            is_triangle_emitted[best_triangle] = true;
+
+            const uint32_t* triangle = &indices[best_triangle * 3];
+            next_cache.assign(triangle, triangle + 3);
+
+            for (int i = 0; i < 3; i++)
+            {
+                const uint32_t vertex = triangle[i];
+                result.push_back(vertex);
+
+                // Swap the triangle out of the vertex's undrawn range
+                uint32_t* vertex_adjacency = &adjacency[adjacency_offsets[vertex]];
+                for (uint32_t j = 0; j < remaining_valence[vertex]; j++)
+                {
+                    if (vertex_adjacency[j] == best_triangle)
+                    {
+                        std::swap(vertex_adjacency[j], vertex_adjacency[remaining_valence[vertex] - 1]);
+                        break;
+                    }
+                }
+                remaining_valence[vertex]--;
+            }
+
+            for (const uint32_t vertex : cache)
+            {
+                if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+                {
+                    next_cache.push_back(vertex);
+                }
+            }
+
+            // Rescore everything that moved in the cache, including what just fell out of it
+            for (size_t i = 0; i < next_cache.size(); i++)
+            {
+                const uint32_t vertex         = next_cache[i];
+                const int      cache_position = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+
+                const float score     = ForsythVertexScore(cache_position, remaining_valence[vertex]);
+                const float delta     = score - vertex_scores[vertex];
+                vertex_scores[vertex] = score;
+
+                for (uint32_t j = 0; j < remaining_valence[vertex]; j++)
+                {
+                    triangle_scores[adjacency[adjacency_offsets[vertex] + j]] += delta;
+                }
+            }
+
+            best_triangle    = INVALID_INDEX;
+            float best_score = -1.f;
+
+            if (next_cache.size() > FORSYTH_CACHE_SIZE)
+            {
+                next_cache.resize(FORSYTH_CACHE_SIZE);
+            }
+
+            for (const uint32_t vertex : next_cache)
+            {
+                for (uint32_t j = 0; j < remaining_valence[vertex]; j++)
+                {
+                    const uint32_t candidate = adjacency[adjacency_offsets[vertex] + j];
+                    if (triangle_scores[candidate] > best_score)
+                    {
+                        best_score    = triangle_scores[candidate];
+                        best_triangle = candidate;
+                    }
+                }
+            }
+
+            std::swap(cache, next_cache);
+        }
+
+        return result;
+    }
+
+    void KitMeshOptimizer::OptimizeVertexFetch(KitMeshData& mesh)
+    {
+        std::vector<uint32_t>  remap(mesh.vertices.size(), INVALID_INDEX);
+        std::vector<KitVertex> fetch_ordered_vertices;
+        fetch_ordered_vertices.reserve(mesh.vertices.size());
+
+        for (uint32_t& index : mesh.indices)
+        {
+            if (remap[index] == INVALID_INDEX)
+            {
+                remap[index] = static_cast<uint32_t>(fetch_ordered_vertices.size());
+                fetch_ordered_vertices.push_back(mesh.vertices[index]);
+            }
+
+            index = remap[index];
+        }
+
+        mesh.vertices = std::move(fetch_ordered_vertices);
+    }
+
+    float KitMeshOptimizer::CalculateAcmr(const std::span<const uint32_t> indices, const size_t vertex_count, const uint32_t cache_size)
+    {
+        const size_t triangle_count = indices.size() / 3;
+        if (triangle_count == 0)
+        {
+            return 0.f;
+        }
+
+        // Timestamp of when each vertex entered the FIFO, it is a hit if it entered within the last cache_size misses
+        std::vector<uint32_t> cache_timestamps(vertex_count, 0);
+        uint32_t              timestamp  = cache_size + 1;
+        uint32_t              miss_count = 0;
+
+        for (const uint32_t index : indices)
+        {
+            if (timestamp - cache_timestamps[index] > cache_size)
+            {
+                cache_timestamps[index] = timestamp++;
+                miss_count++;
+            }
+        }
+
+        return static_cast<float>(miss_count) / static_cast<float>(triangle_count);
+    }
+} // namespace Kitsune
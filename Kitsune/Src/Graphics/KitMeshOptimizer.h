@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "KitModel.h"
+
+namespace Kitsune
+{
+    struct KitMeshOptimizeStats
+    {
+        size_t vertex_count_before = 0;
+        size_t vertex_count_after  = 0;
+        float  acmr_before         = 0.f;
+        float  acmr_after          = 0.f;
+    };
+
+    // Offline style mesh optimizations, run once at import time before the mesh reaches the binary cache
+    class KitMeshOptimizer
+    {
+    public:
+        // FIFO cache size used to report ACMR, matches what most current GPUs behave like
+        static constexpr uint32_t ACMR_CACHE_SIZE = 16;
+
+        // Welds, reorders for the post-transform cache and then for vertex fetch
+        static KitMeshOptimizeStats Optimize(KitMeshData& mesh);
+
+        // Merges bitwise identical vertices and remaps the indices, builds an index list for unindexed meshes
+        static void WeldVertices(KitMeshData& mesh);
+
+        // Forsyth's linear-speed vertex cache optimization, returns the reordered triangle list
+        static std::vector<uint32_t> OptimizeVertexCache(std::span<const uint32_t> indices, size_t vertex_count);
+
+        // Orders vertices by first use in the index buffer and drops unreferenced ones
+        static void OptimizeVertexFetch(KitMeshData& mesh);
+
+        // Average cache miss ratio (transformed vertices per triangle) for a FIFO cache
+        static float CalculateAcmr(std::span<const uint32_t> indices, size_t vertex_count, uint32_t cache_size = ACMR_CACHE_SIZE);
+    };
+} // namespace Kitsune
@@ -1,6 +1,9 @@
 ﻿#include "KitModel.h"
 
+#include <glm/gtc/matrix_transform.hpp>
+
 #include "Core/KitLogs.h"
+#include "Core/System/Subsystems/KitResourceCache.h"
 
 namespace Kitsune
 {
@@ -33,11 +36,48 @@ namespace Kitsune
         return attribute_descriptions;
     }
 
-    KitMesh::KitMesh(KitEngineDevice* device, const KitMeshData& data) :
-        device_(device)
+    std::vector<VkVertexInputBindingDescription> KitPackedVertex::GetBindingDescriptions()
     {
-        CreateVertexBuffers(data.vertices);
-        CreateIndexBuffers(data.indices);
+        std::vector<VkVertexInputBindingDescription> binding_descriptions(1);
+        binding_descriptions[0].binding   = 0;
+        binding_descriptions[0].stride    = sizeof(KitPackedVertex);
+        binding_descriptions[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+        return binding_descriptions;
+    }
+
+    // Locations match KitVertex so both layouts can share the fragment shader
+    std::vector<VkVertexInputAttributeDescription> KitPackedVertex::GetAttributeDescriptions()
+    {
+        std::vector<VkVertexInputAttributeDescription> attribute_descriptions{};
+        // Position
+        attribute_descriptions.emplace_back(0, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(KitPackedVertex, position));
+
+        // Color
+        attribute_descriptions.emplace_back(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(KitPackedVertex, color));
+
+        // Normal
+        attribute_descriptions.emplace_back(2, 0, VK_FORMAT_R16G16_SNORM, offsetof(KitPackedVertex, normal));
+
+        // UV
+        attribute_descriptions.emplace_back(3, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(KitPackedVertex, uv));
+
+        return attribute_descriptions;
+    }
+
+    KitMesh::KitMesh(KitEngineDevice* device, const KitMeshView& data) :
+        arena_(device->GetGeometryArena(data.layout)),
+        layout_(data.layout),
+        bounds_(data.bounds)
+    {
+        if (layout_ == KitVertexLayout::PACKED)
+        {
+            dequantize_matrix_ = glm::scale(glm::translate(glm::mat4{1.f}, data.position_min), data.position_extent);
+        }
+
+        // Copies go out with the next upload flush
+        range_             = arena_->Allocate(data);
+        is_index_available = range_.index_count > 0;
     }
 
     KitMesh::~KitMesh()
@@ -46,38 +86,45 @@ namespace Kitsune
         {
             return;
         }
+
+        arena_->Free(range_);
     }
 
     KitMesh::KitMesh(KitMesh&& other) :
-        device_(other.device_),
-        vertex_buffer_(std::move(other.vertex_buffer_)),
-        vertex_count_(other.vertex_count_),
-        index_buffer_(std::move(other.index_buffer_)),
-        index_count_(other.index_count_)
-    {
-        other.device_        = nullptr;
-        other.vertex_buffer_ = nullptr;
-        other.vertex_count_  = 0;
-        other.index_buffer_  = nullptr;
-        other.index_count_   = 0;
-
+        arena_(other.arena_),
+        range_(other.range_),
+        is_index_available(other.is_index_available),
+        layout_(other.layout_),
+        dequantize_matrix_(other.dequantize_matrix_),
+        bounds_(other.bounds_)
+    {
+        other.arena_    = nullptr;
+        other.range_    = {};
         other.is_moved_ = true;
     }
 
     KitMesh& KitMesh::operator=(KitMesh&& other)
     {
-        device_        = other.device_;
-        vertex_buffer_ = std::move(other.vertex_buffer_);
-        vertex_count_  = other.vertex_count_;
-        index_buffer_  = std::move(other.index_buffer_);
-        index_count_   = other.index_count_;
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        if (!is_moved_)
+        {
+            arena_->Free(range_);
+        }
 
-        other.device_        = nullptr;
-        other.vertex_buffer_ = nullptr;
-        other.vertex_count_  = 0;
-        other.index_buffer_  = nullptr;
-        other.index_count_   = 0;
+        arena_             = other.arena_;
+        range_             = other.range_;
+        is_index_available = other.is_index_available;
+        layout_            = other.layout_;
+        dequantize_matrix_ = other.dequantize_matrix_;
+        bounds_            = other.bounds_;
+        is_moved_          = false;
 
+        other.arena_    = nullptr;
+        other.range_    = {};
         other.is_moved_ = true;
 
         return *this;
@@ -85,123 +132,79 @@ namespace Kitsune
 
     void KitMesh::Bind(VkCommandBuffer command_buffer) const
     {
-        const VkBuffer bufffers[] = {vertex_buffer_->GetBuffer()};
-        VkDeviceSize   offsets[]  = {0};
-        vkCmdBindVertexBuffers(command_buffer, 0, 1, bufffers, offsets);
-
-        if (is_index_available)
-        {
-            vkCmdBindIndexBuffer(command_buffer, index_buffer_->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
-        }
+        arena_->Bind(command_buffer, range_.page);
     }
 
-    void KitMesh::Draw(VkCommandBuffer command_buffer) const
+    void KitMesh::Draw(VkCommandBuffer command_buffer, const uint32_t instance_count, const uint32_t first_instance) const
     {
         if (is_index_available)
         {
-            vkCmdDrawIndexed(command_buffer, index_count_, 1, 0, 0, 0);
+            vkCmdDrawIndexed(command_buffer, range_.index_count, instance_count, range_.first_index,
+                             static_cast<int32_t>(range_.vertex_offset), first_instance);
         }
         else
         {
-            vkCmdDraw(command_buffer, vertex_count_, 1, 0, 0);
+            vkCmdDraw(command_buffer, range_.vertex_count, instance_count, range_.vertex_offset, first_instance);
         }
     }
 
-    void KitMesh::CreateVertexBuffers(const std::vector<KitVertex>& vertices)
+    VkDeviceSize KitMesh::GetGpuSize() const
     {
-        vertex_count_ = static_cast<uint32_t>(vertices.size());
-
-        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, vertex_count_ >= 3, "Vertex count must be at least 3!");
-        VkDeviceSize buffer_size = sizeof(vertices[0]) * vertex_count_;
-        uint32_t     vertex_size = sizeof(vertices[0]);
-
-        // Staging buffer
-        KitGraphicsBuffer staging_buffer(
-            device_,
-            vertex_size,
-            vertex_count_,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        staging_buffer.Map();
-        staging_buffer.WriteToBuffer(vertices.data());
-
-        // Vertex buffer
-        vertex_buffer_ = std::make_unique<KitGraphicsBuffer>(
-            device_,
-            vertex_size,
-            vertex_count_,
-            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-        // Copy staging to vertex
-        device_->CopyBuffer(staging_buffer.GetBuffer(), vertex_buffer_->GetBuffer(), buffer_size);
+        return static_cast<VkDeviceSize>(range_.vertex_count) * arena_->GetVertexStride() +
+               static_cast<VkDeviceSize>(range_.index_count) * sizeof(uint32_t);
     }
 
-    void KitMesh::CreateIndexBuffers(const std::vector<uint32_t>& indices)
+    KitModel::KitModel(std::vector<KitMesh>&& meshes) :
+        meshes_(std::move(meshes))
     {
-        index_count_ = static_cast<uint32_t>(indices.size());
-
-        is_index_available = index_count_ > 0;
-        if (!is_index_available)
+        for (const KitMesh& mesh : meshes_)
         {
-            return;
+            bounds_.Expand(mesh.GetBounds());
         }
-
-        VkDeviceSize buffer_size = sizeof(indices[0]) * index_count_;
-        uint32_t     index_size  = sizeof(indices[0]);
-
-        // Staging buffer
-        KitGraphicsBuffer staging_buffer(
-            device_,
-            index_size,
-            index_count_,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-
-        staging_buffer.Map();
-        staging_buffer.WriteToBuffer(indices.data());
-
-        // Index buffer
-        index_buffer_ = std::make_unique<KitGraphicsBuffer>(
-            device_,
-            index_size,
-            index_count_,
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-
-        // Copy staging to vertex
-        device_->CopyBuffer(staging_buffer.GetBuffer(), index_buffer_->GetBuffer(), buffer_size);
     }
 
-    KitModel::KitModel(std::vector<KitMesh>&& meshes) :
-        meshes_(std::move(meshes))
+    KitModel::~KitModel()
     {
+        meshes_.clear();
     }
 
-    KitModel::~KitModel()
+    void KitModel::AddMesh(KitEngineDevice* device, const KitMeshView& data)
     {
-        meshes_.clear();
+        bounds_.Expand(meshes_.emplace_back(device, data).GetBounds());
     }
 
-    void KitModel::AddMesh(KitEngineDevice* device, const KitMeshData& data)
+    KitResourceFootprint KitModel::GetMemoryFootprint() const
     {
-        meshes_.emplace_back(device, data);
+        KitResourceFootprint footprint{};
+        footprint.cpu_bytes = sizeof(KitModel) + meshes_.capacity() * sizeof(KitMesh);
+
+        for (const KitMesh& mesh : meshes_)
+        {
+            footprint.gpu_bytes += mesh.GetGpuSize();
+        }
+
+        return footprint;
     }
 
     void KitModel::Bind(VkCommandBuffer command_buffer) const
     {
-        for (const KitMesh& mesh : meshes_)
+        if (!meshes_.empty())
         {
-            mesh.Bind(command_buffer);
+            meshes_.front().Bind(command_buffer);
         }
     }
 
     void KitModel::Draw(VkCommandBuffer command_buffer) const
     {
-        for (const KitMesh& mesh : meshes_)
+        // Meshes loaded together are usually in one page, rebind only when that changes
+        for (size_t i = 0; i < meshes_.size(); i++)
         {
-            mesh.Draw(command_buffer);
+            if (i > 0 && !meshes_[i].IsInSamePage(meshes_[i - 1]))
+            {
+                meshes_[i].Bind(command_buffer);
+            }
+
+            meshes_[i].Draw(command_buffer);
         }
     }
 } // namespace Kitsune
@@ -4,13 +4,24 @@
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 #include <glm/glm.hpp>
 #include <memory>
+#include <span>
 #include <vulkan/vulkan_core.h>
 
+#include "KitBounds.h"
 #include "KitEngineDevice.h"
-#include "KitGraphicsBuffer.h"
+#include "KitGeometryArena.h"
+#include "Core/KitDefinitions.h"
 
 namespace Kitsune
 {
+    struct KitResourceFootprint;
+
+    enum class KitVertexLayout : uint32_t
+    {
+        STANDARD, // KitVertex
+        PACKED,   // KitPackedVertex
+    };
+
     struct KitVertex
     {
         glm::vec3 position;
@@ -22,53 +33,149 @@ namespace Kitsune
         static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
     };
 
+    // 20 byte quantized vertex, positions need the owning mesh's dequantize transform
+    struct KitPackedVertex
+    {
+        uint16_t position[4]; // unorm16 within the mesh bounds, w is padding
+        int16_t  normal[2];   // Octahedral snorm16
+        uint8_t  color[4];    // RGBA8 unorm
+        uint16_t uv[2];       // Half floats
+
+        static std::vector<VkVertexInputBindingDescription>   GetBindingDescriptions();
+        static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions();
+    };
+
+    static_assert(sizeof(KitPackedVertex) == 20, "KitPackedVertex must stay tightly packed");
+
+    inline uint32_t GetVertexStride(const KitVertexLayout layout)
+    {
+        return layout == KitVertexLayout::PACKED ? sizeof(KitPackedVertex) : sizeof(KitVertex);
+    }
+
     struct KitMeshData
     {
         std::vector<KitVertex> vertices;
         std::vector<uint32_t>  indices;
+        KitMeshBounds          bounds;
+    };
+
+    struct KitPackedMeshData
+    {
+        std::vector<KitPackedVertex> vertices;
+        std::vector<uint32_t>        indices;
+        KitMeshBounds                bounds;
+
+        // Bounds the unorm16 positions are relative to
+        glm::vec3 position_min{0.f};
+        glm::vec3 position_extent{1.f};
     };
 
+    // Non-owning mesh data of any layout, lets uploads read straight from a mapped cache file
+    struct KitMeshView
+    {
+        KitVertexLayout            layout       = KitVertexLayout::STANDARD;
+        std::span<const std::byte> vertices;
+        uint32_t                   vertex_count = 0;
+        std::span<const uint32_t>  indices;
+        KitMeshBounds              bounds;
+
+        // Only used by the packed layout
+        glm::vec3 position_min{0.f};
+        glm::vec3 position_extent{1.f};
+
+        KitMeshView() = default;
+
+        KitMeshView(const KitMeshData& data) :
+            layout(KitVertexLayout::STANDARD),
+            vertices(std::as_bytes(std::span(data.vertices))),
+            vertex_count(static_cast<uint32_t>(data.vertices.size())),
+            indices(data.indices),
+            bounds(data.bounds)
+        {
+        }
+
+        KitMeshView(const KitPackedMeshData& data) :
+            layout(KitVertexLayout::PACKED),
+            vertices(std::as_bytes(std::span(data.vertices))),
+            vertex_count(static_cast<uint32_t>(data.vertices.size())),
+            indices(data.indices),
+            bounds(data.bounds),
+            position_min(data.position_min),
+            position_extent(data.position_extent)
+        {
+        }
+    };
+
+    // A submesh range inside the device's geometry arena for its layout
     class KitMesh
     {
-        KitEngineDevice* device_;
+        KitGeometryArena* arena_ = nullptr;
+        KitSubmeshRange   range_{};
 
         bool is_index_available = false;
 
-        std::unique_ptr<KitGraphicsBuffer> vertex_buffer_;
-        uint32_t                           vertex_count_;
-
-        std::unique_ptr<KitGraphicsBuffer> index_buffer_;
-        uint32_t                           index_count_;
+        KitVertexLayout layout_ = KitVertexLayout::STANDARD;
+        glm::mat4       dequantize_matrix_{1.f};
+        KitMeshBounds   bounds_;
 
         bool is_moved_ = false;
 
     public:
-        KitMesh(KitEngineDevice* device, const KitMeshData& data);
+        KitMesh(KitEngineDevice* device, const KitMeshView& data);
         ~KitMesh();
 
         KitMesh(KitMesh&& other);
         KitMesh& operator=(KitMesh&& other);
 
+        // Binds the arena page, meshes sharing a page can skip this
         void Bind(VkCommandBuffer command_buffer) const;
-        void Draw(VkCommandBuffer command_buffer) const;
+        void Draw(VkCommandBuffer command_buffer, uint32_t instance_count = 1, uint32_t first_instance = 0) const;
+
+        KIT_NODISCARD bool IsInSamePage(const KitMesh& other) const
+        {
+            return arena_ == other.arena_ && range_.page == other.range_.page;
+        }
 
-    private:
-        void CreateVertexBuffers(const std::vector<KitVertex>& vertices);
-        void CreateIndexBuffers(const std::vector<uint32_t>& indices);
+        KIT_NODISCARD KitVertexLayout GetLayout() const { return layout_; }
+        KIT_NODISCARD const KitSubmeshRange& GetRange() const { return range_; }
+        KIT_NODISCARD VkDeviceSize GetGpuSize() const;
+        KIT_NODISCARD const KitMeshBounds& GetBounds() const { return bounds_; }
+
+        // Maps packed positions back to model space, identity for the standard layout
+        KIT_NODISCARD const glm::mat4& GetDequantizeMatrix() const { return dequantize_matrix_; }
     };
 
     class KitModel
     {
         std::vector<KitMesh> meshes_;
 
+        // Union of the mesh bounds, lets culling reject the whole model with one test
+        KitMeshBounds bounds_;
+
+        // Bumped whenever the meshes are swapped, lets holders notice a reload without being told
+        uint32_t mesh_version_ = 0;
+
     public:
         KitModel() = default;
         explicit KitModel(std::vector<KitMesh>&& meshes);
         ~KitModel();
 
-        void AddMesh(KitEngineDevice* device, const KitMeshData& data);
+        void AddMesh(KitEngineDevice* device, const KitMeshView& data);
+
+        // Exchanges the meshes of both models, used to update a model in place for everyone holding it
+        void SwapMeshes(KitModel& other) noexcept
+        {
+            meshes_.swap(other.meshes_);
+            std::swap(bounds_, other.bounds_);
+            mesh_version_++;
+        }
 
         void Bind(VkCommandBuffer command_buffer) const;
         void Draw(VkCommandBuffer command_buffer) const;
+
+        KIT_NODISCARD const std::vector<KitMesh>& GetMeshes() const { return meshes_; }
+        KIT_NODISCARD const KitMeshBounds& GetBounds() const { return bounds_; }
+        KIT_NODISCARD uint32_t GetMeshVersion() const { return mesh_version_; }
+        KIT_NODISCARD KitResourceFootprint GetMemoryFootprint() const;
     };
 } // namespace Kitsune
@@ -1,5 +1,6 @@
 ﻿#include "KitPipeline.h"
 
+#include <chrono>
 #include <fstream>
 
 #include "Core/KitLogs.h"
@@ -8,6 +9,23 @@
 
 namespace Kitsune
 {
+    namespace
+    {
+        VkShaderModule CreateShaderModule(const VkDevice device, const std::vector<char>& code)
+        {
+            VkShaderModuleCreateInfo create_info{};
+            create_info.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+            create_info.codeSize = code.size();
+            create_info.pCode    = reinterpret_cast<const uint32_t*>(code.data());
+
+            VkShaderModule module = nullptr;
+            VkResult       result = vkCreateShaderModule(device, &create_info, nullptr, &module);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create shader module");
+
+            return module;
+        }
+    }
+
     KitPipeline::KitPipeline(
         KitEngineDevice* device,
         const std::string& vert_path,
@@ -69,8 +87,14 @@ namespace Kitsune
         graphics_pipeline_create_info.basePipelineIndex   = -1;
         graphics_pipeline_create_info.basePipelineHandle  = VK_NULL_HANDLE;
 
-        VkResult result = vkCreateGraphicsPipelines(device_->GetDevice(), VK_NULL_HANDLE, 1, &graphics_pipeline_create_info, nullptr, &graphics_pipeline_);
+        // Timed to compare a cold start against one served by the pipeline cache
+        const auto start_time = std::chrono::steady_clock::now();
+
+        VkResult result = vkCreateGraphicsPipelines(device_->GetDevice(), device_->GetPipelineCache(), 1, &graphics_pipeline_create_info, nullptr, &graphics_pipeline_);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create graphic pipeline!");
+
+        const std::chrono::duration<double, std::milli> creation_time = std::chrono::steady_clock::now() - start_time;
+        KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO, "Created pipeline {} / {} in {:.2f} ms", vert_path, frag_path, creation_time.count());
     }
 
     KitPipeline::~KitPipeline()
@@ -164,12 +188,46 @@ namespace Kitsune
 
     void KitPipeline::CreateShaderModule(const std::vector<char>& code, VkShaderModule* module) const
     {
-        VkShaderModuleCreateInfo create_info{};
-        create_info.sType    = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-        create_info.codeSize = code.size();
-        create_info.pCode    = reinterpret_cast<const uint32_t*>(code.data());
+        *module = Kitsune::CreateShaderModule(device_->GetDevice(), code);
+    }
+
+    KitComputePipeline::KitComputePipeline(
+        KitEngineDevice*       device,
+        const std::string&     comp_path,
+        const VkPipelineLayout pipeline_layout):
+        device_(device)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, pipeline_layout != VK_NULL_HANDLE, "Compute pipeline layout cannot be NULL!");
+
+        comp_shader_module_ = CreateShaderModule(device_->GetDevice(), KitUtil::ReadFile(comp_path));
 
-        VkResult result = vkCreateShaderModule(device_->GetDevice(), &create_info, nullptr, module);
-        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create shader module");
+        VkComputePipelineCreateInfo compute_pipeline_create_info{};
+        compute_pipeline_create_info.sType              = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        compute_pipeline_create_info.stage.sType        = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        compute_pipeline_create_info.stage.stage        = VK_SHADER_STAGE_COMPUTE_BIT;
+        compute_pipeline_create_info.stage.module       = comp_shader_module_;
+        compute_pipeline_create_info.stage.pName        = "main";
+        compute_pipeline_create_info.layout             = pipeline_layout;
+        compute_pipeline_create_info.basePipelineIndex  = -1;
+        compute_pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
+
+        const auto start_time = std::chrono::steady_clock::now();
+
+        VkResult result = vkCreateComputePipelines(device_->GetDevice(), device_->GetPipelineCache(), 1, &compute_pipeline_create_info, nullptr, &compute_pipeline_);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create compute pipeline!");
+
+        const std::chrono::duration<double, std::milli> creation_time = std::chrono::steady_clock::now() - start_time;
+        KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_INFO, "Created compute pipeline {} in {:.2f} ms", comp_path, creation_time.count());
+    }
+
+    KitComputePipeline::~KitComputePipeline()
+    {
+        vkDestroyShaderModule(device_->GetDevice(), comp_shader_module_, nullptr);
+        vkDestroyPipeline(device_->GetDevice(), compute_pipeline_, nullptr);
+    }
+
+    void KitComputePipeline::Bind(const VkCommandBuffer command_buffer) const
+    {
+        vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, compute_pipeline_);
     }
 }
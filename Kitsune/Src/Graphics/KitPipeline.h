@@ -58,4 +58,24 @@ namespace Kitsune
     private:
         void CreateShaderModule(const std::vector<char>& code, VkShaderModule* module) const;
     };
+
+    class KitComputePipeline
+    {
+        KitEngineDevice* device_ = nullptr;
+
+        VkPipeline     compute_pipeline_   = nullptr;
+        VkShaderModule comp_shader_module_ = nullptr;
+
+    public:
+        KitComputePipeline(KitEngineDevice* device, const std::string& comp_path, VkPipelineLayout pipeline_layout);
+        ~KitComputePipeline();
+
+        KitComputePipeline(const KitComputePipeline&) = delete;
+        KitComputePipeline(KitComputePipeline&&)      = delete;
+
+        KitComputePipeline& operator=(const KitComputePipeline&) = delete;
+        KitComputePipeline& operator=(KitComputePipeline&&)      = delete;
+
+        void Bind(const VkCommandBuffer command_buffer) const;
+    };
 }
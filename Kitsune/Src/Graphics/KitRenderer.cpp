@@ -1,13 +1,19 @@
 ﻿#include "KitRenderer.h"
 
+#include "KitGeometryArena.h"
+#include "KitModel.h"
+#include "KitUploadManager.h"
+
 namespace Kitsune
 {
-    KitRenderer::KitRenderer(KitWindow* window, KitEngineDevice* engine_device):
+    KitRenderer::KitRenderer(KitWindow* window, KitEngineDevice* engine_device, const uint32_t recording_participant_count):
         window_(window),
         engine_device_(engine_device)
     {
         RecreateSwapChain();
         CreateCommandBuffers();
+
+        command_recorder_ = std::make_unique<KitCommandRecorder>(engine_device_, recording_participant_count);
     }
 
     KitRenderer::~KitRenderer()
@@ -37,6 +43,10 @@ namespace Kitsune
         VkResult begin_record_result = vkBeginCommandBuffer(command_buffer, &command_begin_info);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, begin_record_result == VK_SUCCESS, "Fail to begin record command buffer {}", current_image_index_);
 
+        // The fence waited on by the image acquisition also covers the secondaries of this frame
+        command_recorder_->BeginFrame(current_frame_index_, swap_chain_->GetRenderPass(),
+                                      swap_chain_->GetFrameBuffer(current_image_index_), swap_chain_->GetSwapChainExtent());
+
         return command_buffer;
     }
 
@@ -49,6 +59,9 @@ namespace Kitsune
         VkResult result = vkEndCommandBuffer(command_buffer);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to end record command buffer");
 
+        // Uploads recorded this frame go out first, the same queue orders them before the frame reads them
+        engine_device_->GetUploadManager()->Flush();
+
         result = swap_chain_->SubmitCommandBuffers(&command_buffer, &current_image_index_);
 
         if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || window_->HasWindowBufferResized())
@@ -61,11 +74,16 @@ namespace Kitsune
             KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to submit command buffer");
         }
 
+        for (const KitVertexLayout layout : {KitVertexLayout::STANDARD, KitVertexLayout::PACKED})
+        {
+            engine_device_->GetGeometryArena(layout)->EndFrame();
+        }
+
         has_frame_started_ = false;
         current_frame_index_ = (current_frame_index_ + 1) % KitSwapChain::MAX_FRAMES_IN_FLIGHT;
     }
 
-    void KitRenderer::BeginSwapChainRenderPass(VkCommandBuffer command_buffer) const
+    void KitRenderer::BeginSwapChainRenderPass(VkCommandBuffer command_buffer, const VkSubpassContents contents) const
     {
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, has_frame_started_, "BeginSwapChainRenderPass() executed while a frame is not in progress!");
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, command_buffer == GetCurrentCommandBuffer(), "BeginSwapChainRenderPass() executed with a different command buffer!");
@@ -86,7 +104,13 @@ namespace Kitsune
         render_pass_begin_info.clearValueCount    = clear_values.size();
         render_pass_begin_info.pClearValues       = clear_values.data();
 
-        vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+        vkCmdBeginRenderPass(command_buffer, &render_pass_begin_info, contents);
+
+        // Secondaries set their own, the primary may only execute them
+        if (contents != VK_SUBPASS_CONTENTS_INLINE)
+        {
+            return;
+        }
 
         // Dynamic viewport/scissor
         VkViewport viewport{};
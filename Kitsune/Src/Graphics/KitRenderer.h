@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include <memory>
 
+#include "KitCommandRecorder.h"
 #include "KitSwapChain.h"
 #include "KitWindow.h"
 #include "Core/KitLogs.h"
@@ -13,16 +14,18 @@ namespace Kitsune
         KitEngineDevice* engine_device_;
 
         std::unique_ptr<KitSwapChain> swap_chain_;
+        std::unique_ptr<KitCommandRecorder> command_recorder_;
 
         std::vector<VkCommandBuffer> command_buffers_;
 
         uint32_t current_image_index_;
-        int      current_frame_index_;
+        int      current_frame_index_ = 0;
 
         bool has_frame_started_ = false;
         
     public:
-        KitRenderer(KitWindow* window, KitEngineDevice* engine_device);
+        // One recording command pool per frame and participant, see KitJobSystem::GetParticipantCount
+        KitRenderer(KitWindow* window, KitEngineDevice* engine_device, uint32_t recording_participant_count = 1);
         ~KitRenderer();
 
         KitRenderer(const KitRenderer&) = delete;
@@ -34,6 +37,8 @@ namespace Kitsune
         KIT_NODISCARD bool IsFrameInProgress() const { return has_frame_started_; }
         KIT_NODISCARD VkRenderPass GetRenderPass() const { return swap_chain_->GetRenderPass(); }
         KIT_NODISCARD float GetAspectRatio() const { return swap_chain_->ExtentAspectRatio(); }
+        KIT_NODISCARD VkExtent2D GetExtent() const { return swap_chain_->GetSwapChainExtent(); }
+        KIT_NODISCARD KitCommandRecorder* GetCommandRecorder() const { return command_recorder_.get(); }
 
         KIT_NODISCARD int GetCurrentFrameIndex() const
         {
@@ -50,7 +55,10 @@ namespace Kitsune
         VkCommandBuffer BeginFrame();
         void EndFrame();
 
-        void BeginSwapChainRenderPass(VkCommandBuffer command_buffer) const;
+        // With VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS the pass only executes buffers from the command recorder
+        void BeginSwapChainRenderPass(
+            VkCommandBuffer   command_buffer,
+            VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) const;
         void EndSwapChainRenderPass(VkCommandBuffer command_buffer) const;
 
     private:
@@ -39,8 +39,7 @@ namespace Kitsune
         for (int i = 0; i < depth_images_.size(); i++)
         {
             vkDestroyImageView(device_->GetDevice(), depth_image_views_[i], nullptr);
-            vkDestroyImage(device_->GetDevice(), depth_images_[i], nullptr);
-            vkFreeMemory(device_->GetDevice(), depth_image_memories_[i], nullptr);
+            device_->DestroyImage(depth_images_[i], depth_image_allocations_[i]);
         }
 
         for (const auto framebuffer : swap_chain_framebuffers_)
@@ -283,9 +282,9 @@ namespace Kitsune
             swap_chain_image_format_     = depth_format;
             VkExtent2D swap_chain_extent = swap_chain_extent_;
 
-            depth_images_        .resize(swap_chain_images_.size());
-            depth_image_memories_.resize(swap_chain_images_.size());
-            depth_image_views_   .resize(swap_chain_images_.size());
+            depth_images_           .resize(swap_chain_images_.size());
+            depth_image_allocations_.resize(swap_chain_images_.size());
+            depth_image_views_      .resize(swap_chain_images_.size());
 
             for (int i = 0; i < depth_images_.size(); i++)
             {
@@ -309,7 +308,7 @@ namespace Kitsune
                     image_info,
                     VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                     depth_images_[i],
-                    depth_image_memories_[i]);
+                    depth_image_allocations_[i]);
 
                 VkImageViewCreateInfo view_info{};
                 view_info.sType                           = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
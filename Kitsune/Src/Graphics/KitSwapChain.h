@@ -24,7 +24,7 @@ namespace Kitsune
 
         std::vector<VkImage> depth_images_;
         
-        std::vector<VkDeviceMemory> depth_image_memories_;
+        std::vector<KitAllocation> depth_image_allocations_;
         std::vector<VkImageView> depth_image_views_;
 
         std::vector<VkSemaphore> image_available_semaphores_;
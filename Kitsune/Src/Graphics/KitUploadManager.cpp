@@ -0,0 +1,319 @@
+#include "KitUploadManager.h"
+
+#include <cstring>
+#include <limits>
+
+#include "KitEngineDevice.h"
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    KitUploadManager::KitUploadManager(KitEngineDevice* device, const VkDeviceSize ring_size) :
+        device_(device),
+        ring_size_((ring_size + COPY_ALIGNMENT - 1) & ~(COPY_ALIGNMENT - 1))
+    {
+        VkCommandPoolCreateInfo pool_info{};
+        pool_info.sType            = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        pool_info.queueFamilyIndex = device_->FindQueueFamilies().graphics_family.value();
+        pool_info.flags            = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+        VkResult result = vkCreateCommandPool(device_->GetDevice(), &pool_info, nullptr, &command_pool_);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create upload command pool!");
+
+        device_->CreateBuffer(
+            ring_size_,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            staging_buffer_,
+            staging_allocation_);
+
+        staging_mapped_ = static_cast<uint8_t*>(staging_allocation_.mapped);
+    }
+
+    KitUploadManager::~KitUploadManager()
+    {
+        WaitIdle();
+
+        for (const KitUploadBatch& batch : free_batches_)
+        {
+            vkDestroyFence(device_->GetDevice(), batch.fence, nullptr);
+        }
+
+        // Command buffers go with the pool
+        vkDestroyCommandPool(device_->GetDevice(), command_pool_, nullptr);
+
+        device_->DestroyBuffer(staging_buffer_, staging_allocation_);
+    }
+
+    uint64_t KitUploadManager::UploadBuffer(
+        const VkBuffer     dst_buffer,
+        const void*        data,
+        const VkDeviceSize size,
+        const VkDeviceSize dst_offset)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, size > 0, "Upload size must be greater than 0!");
+
+        RetireCompletedBatches(false);
+
+        if (recording_batch_.command_buffer == VK_NULL_HANDLE)
+        {
+            BeginBatch();
+        }
+
+        VkBuffer     src_buffer = staging_buffer_;
+        VkDeviceSize src_offset = 0;
+
+        if (size > ring_size_)
+        {
+            // Too big for the ring, give it its own staging buffer that lives as long as the batch
+            VkBuffer      temporary_buffer = VK_NULL_HANDLE;
+            KitAllocation temporary_allocation{};
+            device_->CreateBuffer(
+                size,
+                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                temporary_buffer,
+                temporary_allocation);
+
+            std::memcpy(temporary_allocation.mapped, data, size);
+
+            recording_batch_.temporary_buffers.push_back(temporary_buffer);
+            recording_batch_.temporary_allocations.push_back(temporary_allocation);
+
+            src_buffer = temporary_buffer;
+        }
+        else
+        {
+            // Ring is full, submit what we have and reclaim space from the oldest batch
+            while (!TryAllocateFromRing(size, src_offset))
+            {
+                if (recording_batch_.copy_count > 0)
+                {
+                    Flush();
+                    BeginBatch();
+                }
+
+                KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, !in_flight_batches_.empty(), "Upload ring can not fit {} bytes!", size);
+                RetireCompletedBatches(true);
+            }
+
+            std::memcpy(staging_mapped_ + src_offset, data, size);
+        }
+
+        VkBufferCopy copy_region{};
+        copy_region.srcOffset = src_offset;
+        copy_region.dstOffset = dst_offset;
+        copy_region.size      = size;
+        vkCmdCopyBuffer(recording_batch_.command_buffer, src_buffer, dst_buffer, 1, &copy_region);
+
+        recording_batch_.copy_count++;
+
+        return recording_batch_.id;
+    }
+
+    uint64_t KitUploadManager::Flush()
+    {
+        if (recording_batch_.command_buffer == VK_NULL_HANDLE)
+        {
+            return next_batch_id_ - 1;
+        }
+
+        // One barrier for the whole batch, later submissions on this queue read the data as vertex, index or uniform input
+        VkMemoryBarrier barrier{};
+        barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            recording_batch_.command_buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+            0,
+            1,
+            &barrier,
+            0,
+            nullptr,
+            0,
+            nullptr);
+
+        VkResult result = vkEndCommandBuffer(recording_batch_.command_buffer);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to record upload command buffer!");
+
+        VkSubmitInfo submit_info{};
+        submit_info.sType              = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit_info.commandBufferCount = 1;
+        submit_info.pCommandBuffers    = &recording_batch_.command_buffer;
+
+        result = vkQueueSubmit(device_->GetGraphicsQueue(), 1, &submit_info, recording_batch_.fence);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to submit upload batch!");
+
+        const uint64_t batch_id = recording_batch_.id;
+
+        in_flight_batches_.push_back(std::move(recording_batch_));
+        recording_batch_ = KitUploadBatch{};
+
+        submit_count_++;
+
+        return batch_id;
+    }
+
+    bool KitUploadManager::IsComplete(const uint64_t batch_id)
+    {
+        RetireCompletedBatches(false);
+
+        return batch_id <= completed_batch_id_;
+    }
+
+    void KitUploadManager::Wait(const uint64_t batch_id)
+    {
+        if (recording_batch_.command_buffer != VK_NULL_HANDLE && batch_id >= recording_batch_.id)
+        {
+            Flush();
+        }
+
+        while (completed_batch_id_ < batch_id && !in_flight_batches_.empty())
+        {
+            RetireCompletedBatches(true);
+        }
+    }
+
+    void KitUploadManager::WaitIdle()
+    {
+        Flush();
+
+        while (!in_flight_batches_.empty())
+        {
+            RetireCompletedBatches(true);
+        }
+    }
+
+    bool KitUploadManager::TryAllocateFromRing(const VkDeviceSize size, VkDeviceSize& offset)
+    {
+        const VkDeviceSize aligned_size = (size + COPY_ALIGNMENT - 1) & ~(COPY_ALIGNMENT - 1);
+
+        if (ring_used_ == 0)
+        {
+            ring_head_ = 0;
+            ring_tail_ = 0;
+        }
+
+        VkDeviceSize consumed = 0;
+
+        if (ring_head_ >= ring_tail_ && ring_used_ < ring_size_)
+        {
+            // Free space is [head, end) followed by [0, tail)
+            if (ring_size_ - ring_head_ >= aligned_size)
+            {
+                offset   = ring_head_;
+                consumed = aligned_size;
+            }
+            else if (ring_tail_ >= aligned_size)
+            {
+                // Skip the tail end of the ring, it is given back when this batch retires
+                offset   = 0;
+                consumed = ring_size_ - ring_head_ + aligned_size;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        else if (ring_head_ < ring_tail_ && ring_tail_ - ring_head_ >= aligned_size)
+        {
+            offset   = ring_head_;
+            consumed = aligned_size;
+        }
+        else
+        {
+            return false;
+        }
+
+        ring_head_  = offset + aligned_size;
+        ring_used_ += consumed;
+
+        recording_batch_.ring_consumed += consumed;
+        recording_batch_.ring_end       = ring_head_;
+
+        return true;
+    }
+
+    void KitUploadManager::BeginBatch()
+    {
+        if (!free_batches_.empty())
+        {
+            recording_batch_ = std::move(free_batches_.back());
+            free_batches_.pop_back();
+
+            vkResetCommandBuffer(recording_batch_.command_buffer, 0);
+            vkResetFences(device_->GetDevice(), 1, &recording_batch_.fence);
+        }
+        else
+        {
+            VkCommandBufferAllocateInfo alloc_info{};
+            alloc_info.sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            alloc_info.level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            alloc_info.commandPool        = command_pool_;
+            alloc_info.commandBufferCount = 1;
+
+            VkResult result = vkAllocateCommandBuffers(device_->GetDevice(), &alloc_info, &recording_batch_.command_buffer);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to allocate upload command buffer!");
+
+            VkFenceCreateInfo fence_info{};
+            fence_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+            result = vkCreateFence(device_->GetDevice(), &fence_info, nullptr, &recording_batch_.fence);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create upload fence!");
+        }
+
+        recording_batch_.id            = next_batch_id_++;
+        recording_batch_.ring_consumed = 0;
+        recording_batch_.ring_end      = ring_head_;
+        recording_batch_.copy_count    = 0;
+
+        VkCommandBufferBeginInfo begin_info{};
+        begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        vkBeginCommandBuffer(recording_batch_.command_buffer, &begin_info);
+    }
+
+    void KitUploadManager::RetireCompletedBatches(const bool wait_for_oldest)
+    {
+        if (wait_for_oldest && !in_flight_batches_.empty())
+        {
+            vkWaitForFences(device_->GetDevice(), 1, &in_flight_batches_.front().fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+        }
+
+        // Batches complete in submission order, so the ring tail only ever moves forward
+        while (!in_flight_batches_.empty() && vkGetFenceStatus(device_->GetDevice(), in_flight_batches_.front().fence) == VK_SUCCESS)
+        {
+            KitUploadBatch& batch = in_flight_batches_.front();
+
+            // A batch made only of oversized copies never touched the ring, its end may be stale
+            if (batch.ring_consumed > 0)
+            {
+                ring_used_ -= batch.ring_consumed;
+                ring_tail_  = batch.ring_end;
+            }
+
+            completed_batch_id_ = batch.id;
+
+            ReleaseBatch(batch);
+
+            free_batches_.push_back(std::move(batch));
+            in_flight_batches_.pop_front();
+        }
+    }
+
+    void KitUploadManager::ReleaseBatch(KitUploadBatch& batch)
+    {
+        for (size_t i = 0; i < batch.temporary_buffers.size(); i++)
+        {
+            device_->DestroyBuffer(batch.temporary_buffers[i], batch.temporary_allocations[i]);
+        }
+
+        batch.temporary_buffers.clear();
+        batch.temporary_allocations.clear();
+    }
+} // namespace Kitsune
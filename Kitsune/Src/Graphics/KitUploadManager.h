@@ -0,0 +1,83 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+#include "KitMemoryAllocator.h"
+#include "Core/KitDefinitions.h"
+
+namespace Kitsune
+{
+    class KitEngineDevice;
+
+    // Streams data to device local buffers through a persistently mapped staging ring.
+    // Copies are batched into one command buffer per Flush() and tracked with a fence, nothing waits on the queue.
+    // Main thread only.
+    class KitUploadManager final
+    {
+        struct KitUploadBatch
+        {
+            uint64_t        id             = 0;
+            VkCommandBuffer command_buffer = VK_NULL_HANDLE;
+            VkFence         fence          = VK_NULL_HANDLE;
+            VkDeviceSize    ring_consumed  = 0; // Bytes of the ring this batch holds, including wrap padding
+            VkDeviceSize    ring_end       = 0; // Ring head after the batch's last allocation
+            uint32_t        copy_count     = 0;
+
+            // Staging buffers for copies bigger than the ring, released with the batch
+            std::vector<VkBuffer>      temporary_buffers;
+            std::vector<KitAllocation> temporary_allocations;
+        };
+
+        KitEngineDevice* device_;
+
+        VkCommandPool command_pool_ = VK_NULL_HANDLE;
+
+        VkBuffer      staging_buffer_     = VK_NULL_HANDLE;
+        KitAllocation staging_allocation_{};
+        uint8_t*      staging_mapped_     = nullptr;
+
+        VkDeviceSize ring_size_ = 0;
+        VkDeviceSize ring_head_ = 0;
+        VkDeviceSize ring_tail_ = 0;
+        VkDeviceSize ring_used_ = 0;
+
+        KitUploadBatch              recording_batch_{};
+        std::deque<KitUploadBatch>  in_flight_batches_;
+        std::vector<KitUploadBatch> free_batches_;
+
+        uint64_t next_batch_id_      = 1;
+        uint64_t completed_batch_id_ = 0;
+        uint64_t submit_count_       = 0;
+
+    public:
+        static constexpr VkDeviceSize DEFAULT_RING_SIZE = 64ull * 1024 * 1024;
+        static constexpr VkDeviceSize COPY_ALIGNMENT    = 16;
+
+        explicit KitUploadManager(KitEngineDevice* device, VkDeviceSize ring_size = DEFAULT_RING_SIZE);
+        ~KitUploadManager();
+
+        KitUploadManager(const KitUploadManager&)            = delete;
+        KitUploadManager& operator=(const KitUploadManager&) = delete;
+
+        // Copies data into staging and records a copy into dst_buffer, returns the id of the batch it will be submitted in.
+        // dst_buffer must have VK_BUFFER_USAGE_TRANSFER_DST_BIT and stay alive until that batch completes.
+        uint64_t UploadBuffer(VkBuffer dst_buffer, const void* data, VkDeviceSize size, VkDeviceSize dst_offset = 0);
+
+        // Submits everything recorded so far, returns the submitted batch id or the last one if there was nothing to submit
+        uint64_t Flush();
+
+        KIT_NODISCARD bool IsComplete(uint64_t batch_id);
+        void Wait(uint64_t batch_id);
+        void WaitIdle();
+
+        KIT_NODISCARD uint64_t GetSubmitCount() const { return submit_count_; }
+
+    private:
+        bool TryAllocateFromRing(VkDeviceSize size, VkDeviceSize& offset);
+        void BeginBatch();
+        void RetireCompletedBatches(bool wait_for_oldest);
+        void ReleaseBatch(KitUploadBatch& batch);
+    };
+} // namespace Kitsune
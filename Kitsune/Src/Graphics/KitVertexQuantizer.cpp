@@ -0,0 +1,107 @@
+#include "KitVertexQuantizer.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+
+namespace Kitsune
+{
+    namespace
+    {
+        // Maps the unit sphere onto the [-1, 1] square, see "A Survey of Efficient Representations for Independent Unit Vectors"
+        glm::vec2 OctahedralEncode(const glm::vec3& normal)
+        {
+            const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+            if (length == 0.f)
+            {
+                return {0.f, 0.f};
+            }
+
+            glm::vec2 encoded = glm::vec2(normal.x, normal.y) / length;
+
+            // Fold the lower hemisphere over the diagonals
+            if (normal.z < 0.f)
+            {
+                encoded = glm::vec2(
+                    (1.f - std::abs(encoded.y)) * (encoded.x >= 0.f ? 1.f : -1.f),
+                    (1.f - std::abs(encoded.x)) * (encoded.y >= 0.f ? 1.f : -1.f));
+            }
+
+            return encoded;
+        }
+    }
+
+    KitVertexLayout KitVertexQuantizer::ChooseLayout(const KitMeshData& mesh)
+    {
+        if (mesh.vertices.empty())
+        {
+            return KitVertexLayout::STANDARD;
+        }
+
+        for (const KitVertex& vertex : mesh.vertices)
+        {
+            if (std::abs(vertex.uv.x) > PACKED_UV_LIMIT || std::abs(vertex.uv.y) > PACKED_UV_LIMIT)
+            {
+                return KitVertexLayout::STANDARD;
+            }
+        }
+
+        return KitVertexLayout::PACKED;
+    }
+
+    KitPackedMeshData KitVertexQuantizer::Pack(const KitMeshData& mesh)
+    {
+        KitPackedMeshData packed_mesh{};
+        packed_mesh.indices = mesh.indices;
+
+        glm::vec3 position_min = mesh.vertices.empty() ? glm::vec3(0.f) : mesh.vertices[0].position;
+        glm::vec3 position_max = position_min;
+
+        for (const KitVertex& vertex : mesh.vertices)
+        {
+            position_min = glm::min(position_min, vertex.position);
+            position_max = glm::max(position_max, vertex.position);
+        }
+
+        // Flat axes still need a non zero extent for the dequantize transform to stay invertible
+        glm::vec3 position_extent = position_max - position_min;
+        for (int i = 0; i < 3; i++)
+        {
+            if (position_extent[i] <= 0.f)
+            {
+                position_extent[i] = 1.f;
+            }
+        }
+
+        packed_mesh.bounds          = mesh.bounds;
+        packed_mesh.position_min    = position_min;
+        packed_mesh.position_extent = position_extent;
+
+        packed_mesh.vertices.reserve(mesh.vertices.size());
+        for (const KitVertex& vertex : mesh.vertices)
+        {
+            KitPackedVertex packed_vertex{};
+
+            const glm::vec3 position = (vertex.position - position_min) / position_extent;
+            packed_vertex.position[0] = glm::packUnorm1x16(position.x);
+            packed_vertex.position[1] = glm::packUnorm1x16(position.y);
+            packed_vertex.position[2] = glm::packUnorm1x16(position.z);
+            packed_vertex.position[3] = 0;
+
+            const glm::vec2 normal  = OctahedralEncode(vertex.normal);
+            packed_vertex.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(normal.x));
+            packed_vertex.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(normal.y));
+
+            const uint32_t color = glm::packUnorm4x8(glm::vec4(vertex.color, 1.f));
+            std::memcpy(packed_vertex.color, &color, sizeof(color));
+
+            packed_vertex.uv[0] = glm::packHalf1x16(vertex.uv.x);
+            packed_vertex.uv[1] = glm::packHalf1x16(vertex.uv.y);
+
+            packed_mesh.vertices.push_back(packed_vertex);
+        }
+
+        return packed_mesh;
+    }
+} // namespace Kitsune
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "KitModel.h"
+
+namespace Kitsune
+{
+    // Converts imported meshes to KitPackedVertex when the precision loss is acceptable
+    class KitVertexQuantizer
+    {
+    public:
+        // Half floats keep at least 1/256 precision below this, enough for a 256 texel repeat
+        static constexpr float PACKED_UV_LIMIT = 8.f;
+
+        static KitVertexLayout ChooseLayout(const KitMeshData& mesh);
+        static KitPackedMeshData Pack(const KitMeshData& mesh);
+    };
+} // namespace Kitsune
@@ -1,80 +1,222 @@
 ﻿#include "KitBasicRenderSystem.h"
 
+#include <algorithm>
 #include <ranges>
 
 #include "Core/KitLogs.h"
 #include "Graphics/KitGlobalGraphicsDefines.h"
+#include "Graphics/KitModel.h"
+#include "Graphics/KitSwapChain.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 
 namespace Kitsune
 {
-    struct KitPushConstantsData
+    // Read by the vertex shaders at locations 4 to 11, a mat4 takes one location per column
+    struct KitInstanceData
     {
         glm::mat4 model_matrix{1.f}; // Default id matrix init
         glm::mat4 normal_matrix{1.f};
     };
 
+    namespace
+    {
+        void AddInstanceInput(PipelineConfigInfo& config_info, const uint32_t binding)
+        {
+            config_info.vertex_input_binding_descriptions.emplace_back(binding, sizeof(KitInstanceData),
+                                                                       VK_VERTEX_INPUT_RATE_INSTANCE);
+
+            constexpr uint32_t first_location = 4;
+            for (uint32_t column = 0; column < 4; column++)
+            {
+                config_info.vertex_input_attribute_descriptions.emplace_back(
+                    first_location + column, binding, VK_FORMAT_R32G32B32A32_SFLOAT,
+                    offsetof(KitInstanceData, model_matrix) + column * sizeof(glm::vec4));
+
+                config_info.vertex_input_attribute_descriptions.emplace_back(
+                    first_location + 4 + column, binding, VK_FORMAT_R32G32B32A32_SFLOAT,
+                    offsetof(KitInstanceData, normal_matrix) + column * sizeof(glm::vec4));
+            }
+        }
+    }
+
     KitBasicRenderSystem::KitBasicRenderSystem(
         KitEngineDevice* device):
         KitRenderSystemBase(device)
     {
+        instance_buffers_.resize(KitSwapChain::MAX_FRAMES_IN_FLIGHT);
     }
 
-    void KitBasicRenderSystem::Render(const KitFrameInfo& frame_info) const
+    void KitBasicRenderSystem::Prepare(const KitFrameInfo& frame_info)
     {
-        pipeline_->Bind(frame_info.command_buffer);
-
-        vkCmdBindDescriptorSets(
-            frame_info.command_buffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            pipeline_layout_,
-            0,
-            1,
-            &frame_info.descriptor_set,
-            0,
-            nullptr);
-
-        for (auto& game_obj : frame_info.game_objects)
+        const std::vector<KitVisibleMesh>& visible_meshes = frame_info.visible_meshes;
+
+        draws_.clear();
+        draw_of_mesh_.clear();
+        instance_draws_.resize(visible_meshes.size());
+
+        // Count the instances of every mesh, remembering the draw of each instance for the scatter below
+        for (size_t i = 0; i < visible_meshes.size(); i++)
         {
-            if (game_obj.model == nullptr)
+            const auto [it, is_new] = draw_of_mesh_.try_emplace(visible_meshes[i].mesh, static_cast<uint32_t>(draws_.size()));
+            if (is_new)
             {
-                continue;
+                draws_.push_back({visible_meshes[i].mesh, 0, 0});
             }
 
-            KitPushConstantsData push_constants_data{};
-            push_constants_data.model_matrix  = game_obj.transform.ToMatrix();
-            push_constants_data.normal_matrix = game_obj.transform.GetNormalMatrix();
+            draws_[it->second].instance_count++;
+            instance_draws_[i] = it->second;
+        }
+
+        draw_order_.resize(draws_.size());
+        for (uint32_t i = 0; i < draw_order_.size(); i++)
+        {
+            draw_order_[i] = i;
+        }
+
+        std::ranges::sort(draw_order_, [this](const uint32_t left, const uint32_t right)
+        {
+            const KitMesh& left_mesh  = *draws_[left].mesh;
+            const KitMesh& right_mesh = *draws_[right].mesh;
+
+            if (left_mesh.GetLayout() != right_mesh.GetLayout())
+            {
+                return left_mesh.GetLayout() < right_mesh.GetLayout();
+            }
+
+            return left_mesh.GetRange().page < right_mesh.GetRange().page;
+        });
+
+        // Reorder the draws and give each one its range of the instance buffer
+        sorted_draws_.resize(draws_.size());
+        draw_remap_.resize(draws_.size());
+
+        uint32_t instance_count = 0;
+        for (uint32_t i = 0; i < draw_order_.size(); i++)
+        {
+            KitInstancedDraw& draw = sorted_draws_[i];
+
+            draw                        = draws_[draw_order_[i]];
+            draw.first_instance         = instance_count;
+            draw_remap_[draw_order_[i]] = i;
+
+            // Counted again while the instances are written
+            instance_count += draw.instance_count;
+            draw.instance_count = 0;
+        }
+
+        draws_.swap(sorted_draws_);
+
+        KitGraphicsBuffer::Reserve(
+            engine_device_,
+            instance_buffers_[frame_info.frame_index],
+            sizeof(KitInstanceData),
+            std::max(instance_count, INITIAL_INSTANCE_CAPACITY),
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+        const KitGraphicsBuffer& instance_buffer = *instance_buffers_[frame_info.frame_index];
+        auto* instances = static_cast<KitInstanceData*>(instance_buffer.GetMappedMemory());
+
+        for (size_t i = 0; i < visible_meshes.size(); i++)
+        {
+            KitInstancedDraw&        draw      = draws_[draw_remap_[instance_draws_[i]]];
+            const KitWorldTransform& transform = *visible_meshes[i].transform;
+            KitInstanceData&         instance  = instances[draw.first_instance + draw.instance_count++];
+
+            // Packed positions are in mesh bounds space, the dequantize is folded into the model matrix.
+            // Normals are not bounds relative so the normal matrix stays as is.
+            instance.model_matrix  = draw.mesh->GetLayout() == KitVertexLayout::PACKED
+                                         ? transform.model_matrix * draw.mesh->GetDequantizeMatrix()
+                                         : transform.model_matrix;
+            instance.normal_matrix = transform.normal_matrix;
+        }
+
+        // Manual flush, the buffer is not host coherent
+        if (instance_count > 0)
+        {
+            instance_buffer.Flush();
+        }
+
+        stats_.draw_count     = static_cast<uint32_t>(draws_.size());
+        stats_.instance_count = instance_count;
+    }
+
+    void KitBasicRenderSystem::Render(const KitFrameInfo& frame_info) const
+    {
+        RenderChunk(frame_info, 0, 1);
+    }
 
-            vkCmdPushConstants(
-                frame_info.command_buffer,
-                pipeline_layout_,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(push_constants_data),
-                &push_constants_data);
+    uint32_t KitBasicRenderSystem::GetRenderChunkCount(const uint32_t max_chunk_count) const
+    {
+        const uint32_t draw_count = static_cast<uint32_t>(draws_.size());
+        return std::clamp(draw_count / MIN_DRAWS_PER_CHUNK, 1u, std::max(max_chunk_count, 1u));
+    }
+
+    void KitBasicRenderSystem::RenderChunk(const KitFrameInfo& frame_info, const uint32_t chunk, const uint32_t chunk_count) const
+    {
+        // Contiguous ranges keep the runs of draws sharing a pipeline and an arena page together
+        const size_t first_draw = draws_.size() * chunk / chunk_count;
+        const size_t last_draw  = draws_.size() * (chunk + 1) / chunk_count;
 
-            game_obj.model->Bind(frame_info.command_buffer);
-            game_obj.model->Draw(frame_info.command_buffer);
+        if (first_draw == last_draw)
+        {
+            return;
+        }
+
+        const VkBuffer     instance_buffer = instance_buffers_[frame_info.frame_index]->GetBuffer();
+        const VkDeviceSize offset          = 0;
+        vkCmdBindVertexBuffers(frame_info.command_buffer, INSTANCE_BINDING, 1, &instance_buffer, &offset);
+
+        const KitPipeline* bound_pipeline = nullptr;
+        const KitMesh*     bound_mesh     = nullptr;
+
+        for (size_t i = first_draw; i < last_draw; i++)
+        {
+            const KitInstancedDraw& draw     = draws_[i];
+            const KitMesh&          mesh     = *draw.mesh;
+            const KitPipeline*      pipeline = mesh.GetLayout() == KitVertexLayout::PACKED ? packed_pipeline_.get()
+                                                                                           : pipeline_.get();
+
+            if (pipeline != bound_pipeline)
+            {
+                pipeline->Bind(frame_info.command_buffer);
+
+                vkCmdBindDescriptorSets(
+                    frame_info.command_buffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    pipeline_layout_,
+                    0,
+                    1,
+                    &frame_info.descriptor_set,
+                    0,
+                    nullptr);
+
+                bound_pipeline = pipeline;
+            }
+
+            // Every mesh in an arena page shares its buffers, one bind covers the run
+            if (bound_mesh == nullptr || !mesh.IsInSamePage(*bound_mesh))
+            {
+                mesh.Bind(frame_info.command_buffer);
+                bound_mesh = &mesh;
+            }
+
+            mesh.Draw(frame_info.command_buffer, draw.instance_count, draw.first_instance);
         }
     }
 
     void KitBasicRenderSystem::CreatePipelineLayout(VkDescriptorSetLayout descriptor_set_layout)
     {
-        VkPushConstantRange push_constant_range;
-        push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        push_constant_range.offset     = 0;
-        push_constant_range.size       = sizeof(KitPushConstantsData);
-
         std::vector<VkDescriptorSetLayout> set_layouts_sets{descriptor_set_layout};
 
         VkPipelineLayoutCreateInfo create_info{};
         create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         create_info.setLayoutCount         = set_layouts_sets.size();
         create_info.pSetLayouts            = set_layouts_sets.data();
-        create_info.pushConstantRangeCount = 1;
-        create_info.pPushConstantRanges    = &push_constant_range;
+        create_info.pushConstantRangeCount = 0;
+        create_info.pPushConstantRanges    = nullptr;
 
         VkResult result = vkCreatePipelineLayout(engine_device_->GetDevice(), &create_info, nullptr, &pipeline_layout_);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create pipeline layout!");
@@ -86,6 +228,7 @@ namespace Kitsune
 
         PipelineConfigInfo pipeline_config{};
         KitPipeline::DefaultPipelineConfigInfo(pipeline_config);
+        AddInstanceInput(pipeline_config, INSTANCE_BINDING);
 
         pipeline_config.render_pass     = render_pass;
         pipeline_config.pipeline_layout = pipeline_layout_;
@@ -95,5 +238,20 @@ namespace Kitsune
             "Shader/Simple3DVert.spv",
             "Shader/Simple3DFrag.spv",
             pipeline_config);
+
+        PipelineConfigInfo packed_pipeline_config{};
+        KitPipeline::DefaultPipelineConfigInfo(packed_pipeline_config);
+
+        packed_pipeline_config.render_pass                         = render_pass;
+        packed_pipeline_config.pipeline_layout                     = pipeline_layout_;
+        packed_pipeline_config.vertex_input_binding_descriptions   = KitPackedVertex::GetBindingDescriptions();
+        packed_pipeline_config.vertex_input_attribute_descriptions = KitPackedVertex::GetAttributeDescriptions();
+        AddInstanceInput(packed_pipeline_config, INSTANCE_BINDING);
+
+        packed_pipeline_ = std::make_unique<KitPipeline>(
+            engine_device_,
+            "Shader/Simple3DPackedVert.spv",
+            "Shader/Simple3DFrag.spv",
+            packed_pipeline_config);
     }
 }
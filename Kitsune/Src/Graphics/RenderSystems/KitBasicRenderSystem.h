@@ -1,16 +1,66 @@
 ﻿#pragma once
 
+#include <unordered_map>
+#include <vector>
+
 #include "KitRenderSystemBase.h"
+#include "Graphics/KitGraphicsBuffer.h"
 
 namespace Kitsune
 {
+    class KitMesh;
+
+    struct KitBasicRenderStats
+    {
+        uint32_t draw_count     = 0;
+        uint32_t instance_count = 0;
+    };
+
+    // Draws the visible meshes grouped by mesh, one instanced draw per group. Prepare writes the transforms of each group
+    // contiguously into the instance buffer of the frame, which the vertex shaders read at an instance rate binding.
     class KitBasicRenderSystem : public KitRenderSystemBase
     {
+        static constexpr uint32_t INSTANCE_BINDING          = 1;
+        static constexpr uint32_t INITIAL_INSTANCE_CAPACITY = 1024;
+
+        // Fewer draws do not pay for another secondary command buffer
+        static constexpr uint32_t MIN_DRAWS_PER_CHUNK = 64;
+
+        struct KitInstancedDraw
+        {
+            const KitMesh* mesh           = nullptr;
+            uint32_t       first_instance = 0;
+            uint32_t       instance_count = 0;
+        };
+
+        // Same layout and fragment shader as pipeline_, reads KitPackedVertex
+        std::unique_ptr<KitPipeline> packed_pipeline_ = nullptr;
+
+        // One per frame in flight, regrown in Prepare once the frame's fence has released it
+        std::vector<std::unique_ptr<KitGraphicsBuffer>> instance_buffers_;
+
+        // Sorted by layout then arena page, so each pipeline and each page is bound once
+        std::vector<KitInstancedDraw> draws_;
+        KitBasicRenderStats           stats_;
+
+        // Scratch reused every frame
+        std::unordered_map<const KitMesh*, uint32_t> draw_of_mesh_;
+        std::vector<uint32_t>                        instance_draws_;
+        std::vector<uint32_t>                        draw_order_;
+        std::vector<uint32_t>                        draw_remap_;
+        std::vector<KitInstancedDraw>                sorted_draws_;
+
     public:
         explicit KitBasicRenderSystem(KitEngineDevice* device);
 
+        void Prepare(const KitFrameInfo& frame_info) override;
         void Render(const KitFrameInfo& frame_info) const override;
 
+        KIT_NODISCARD uint32_t GetRenderChunkCount(uint32_t max_chunk_count) const override;
+        void RenderChunk(const KitFrameInfo& frame_info, uint32_t chunk, uint32_t chunk_count) const override;
+
+        KIT_NODISCARD const KitBasicRenderStats& GetStats() const { return stats_; }
+
     protected:
         void CreatePipelineLayout(VkDescriptorSetLayout descriptor_set_layout) override;
         void CreatePipeline(VkRenderPass render_pass) override;
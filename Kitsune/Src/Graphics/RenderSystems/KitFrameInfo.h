@@ -3,7 +3,8 @@
 #include <vulkan/vulkan.h>
 
 #include "Graphics/KitCamera.h"
-#include "Core/Scene/KitGameObject.h"
+#include "Graphics/KitFrustumCuller.h"
+#include "Core/Scene/KitScene.h"
 
 namespace Kitsune
 {
@@ -14,6 +15,9 @@ namespace Kitsune
         VkCommandBuffer command_buffer;
         KitCamera*      camera;
         VkDescriptorSet descriptor_set;
-        std::vector<KitGameObject>& game_objects;
+        KitScene&       scene;
+
+        // Filled by the culling pass between the render system updates and Render
+        const std::vector<KitVisibleMesh>& visible_meshes;
     };
 } // namespace Kitsune
@@ -1,55 +1,82 @@
 ﻿#include "KitGizmoBillboardRenderSystem.h"
 
+#include <algorithm>
 #include <ranges>
 
 #include "Core/KitLogs.h"
+#include "Graphics/KitSwapChain.h"
 
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
 
 namespace Kitsune
 {
-    struct KitPushConstantsData
+    // Read by the vertex shader at an instance rate binding
+    struct KitBillboardInstance
     {
-        glm::vec4 position{};
+        glm::vec4 position{}; // w is the radius
         glm::vec4 color{};
-        float radius;
     };
 
     KitGizmoBillboardRenderSystem::KitGizmoBillboardRenderSystem(
         KitEngineDevice*      device):
         KitRenderSystemBase(device)
     {
+        instance_buffers_.resize(KitSwapChain::MAX_FRAMES_IN_FLIGHT);
     }
 
     void KitGizmoBillboardRenderSystem::Update(const KitFrameInfo& frame_info, KitGlobalUBO& ubo)
     {
         auto rotate_light = glm::rotate(glm::mat4(1.f), 0.5f * frame_info.frame_time, {0.f, -1.f, 0.f});
-        int  light_index  = 0;
-        for (auto& obj : frame_info.game_objects)
+        frame_info.scene.GetPointLightQuery().each(
+            [&](const flecs::entity entity, KitTransform& transform, const KitWorldTransform&, const KitColorComponent& color,
+                const KitPointLightComponent& point_light)
         {
-            if (obj.point_light_component == nullptr)
-            {
-                continue;
-            }
-
-            assert(light_index < MAX_LIGHTS && "Point lights exceed maximum specified");
+            // update light position, KitClusteredLighting picks it up for the shaders
+            transform.translation = glm::vec3(rotate_light * glm::vec4(transform.translation, 1.f));
+            frame_info.scene.MarkTransformDirty(entity);
+        });
+    }
 
-            // update light position
-            obj.transform.translation = glm::vec3(rotate_light * glm::vec4(obj.transform.translation, 1.f));
+    void KitGizmoBillboardRenderSystem::Prepare(const KitFrameInfo& frame_info)
+    {
+        const KitPointLightQuery& query = frame_info.scene.GetPointLightQuery();
 
-            // copy light to ubo
-            ubo.point_lights[light_index].position = glm::vec4(obj.transform.translation, 1.f);
-            ubo.point_lights[light_index].color    = glm::vec4(obj.color, obj.point_light_component->light_intensity);
+        KitGraphicsBuffer::Reserve(
+            engine_device_,
+            instance_buffers_[frame_info.frame_index],
+            sizeof(KitBillboardInstance),
+            std::max(static_cast<uint32_t>(query.count()), INITIAL_INSTANCE_CAPACITY),
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+        const KitGraphicsBuffer& instance_buffer = *instance_buffers_[frame_info.frame_index];
+        auto* instances = static_cast<KitBillboardInstance*>(instance_buffer.GetMappedMemory());
+
+        billboard_count_ = 0;
+        query.each(
+            [&](const KitTransform& transform, const KitWorldTransform& world_transform, const KitColorComponent& color,
+                const KitPointLightComponent& point_light)
+        {
+            // The radius stays the light's own, the position follows its parents
+            KitBillboardInstance& instance = instances[billboard_count_++];
+            instance.position = glm::vec4(glm::vec3(world_transform.model_matrix[3]), transform.scale.x);
+            instance.color    = glm::vec4(color.color, point_light.light_intensity);
+        });
 
-            light_index++;
+        if (billboard_count_ > 0)
+        {
+            instance_buffer.Flush();
         }
-
-        ubo.num_lights = light_index;
     }
 
     void KitGizmoBillboardRenderSystem::Render(const KitFrameInfo& frame_info) const
     {
+        if (billboard_count_ == 0)
+        {
+            return;
+        }
+
         pipeline_->Bind(frame_info.command_buffer);
 
         vkCmdBindDescriptorSets(
@@ -62,42 +89,23 @@ namespace Kitsune
             0,
             nullptr);
 
-        for (auto& obj : frame_info.game_objects)
-        {
-            if (obj.point_light_component == nullptr)
-                continue;
-
-            KitPushConstantsData push{};
-            push.position = glm::vec4(obj.transform.translation, 1.f);
-            push.color    = glm::vec4(obj.color, obj.point_light_component->light_intensity);
-            push.radius   = obj.transform.scale.x;
-
-            vkCmdPushConstants(
-                frame_info.command_buffer,
-                pipeline_layout_,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0,
-                sizeof(KitPushConstantsData),
-                &push);
-            vkCmdDraw(frame_info.command_buffer, 6, 1, 0, 0);
-        }
+        const VkBuffer     instance_buffer = instance_buffers_[frame_info.frame_index]->GetBuffer();
+        const VkDeviceSize offset          = 0;
+        vkCmdBindVertexBuffers(frame_info.command_buffer, INSTANCE_BINDING, 1, &instance_buffer, &offset);
+
+        vkCmdDraw(frame_info.command_buffer, 6, billboard_count_, 0, 0);
     }
 
     void KitGizmoBillboardRenderSystem::CreatePipelineLayout(VkDescriptorSetLayout descriptor_set_layout)
     {
-        VkPushConstantRange push_constant_range;
-        push_constant_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
-        push_constant_range.offset     = 0;
-        push_constant_range.size       = sizeof(KitPushConstantsData);
-
         std::vector<VkDescriptorSetLayout> set_layouts_sets{descriptor_set_layout};
 
         VkPipelineLayoutCreateInfo create_info{};
         create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
         create_info.setLayoutCount         = set_layouts_sets.size();
         create_info.pSetLayouts            = set_layouts_sets.data();
-        create_info.pushConstantRangeCount = 1;
-        create_info.pPushConstantRanges    = &push_constant_range;
+        create_info.pushConstantRangeCount = 0;
+        create_info.pPushConstantRanges    = nullptr;
 
         VkResult result = vkCreatePipelineLayout(engine_device_->GetDevice(), &create_info, nullptr, &pipeline_layout_);
         KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create pipeline layout!");
@@ -110,8 +118,14 @@ namespace Kitsune
         PipelineConfigInfo pipeline_config{};
         KitPipeline::DefaultPipelineConfigInfo(pipeline_config);
 
-        pipeline_config.vertex_input_attribute_descriptions.clear();
-        pipeline_config.vertex_input_binding_descriptions.clear();
+        // No vertex buffer, the quad corners come from gl_VertexIndex and each billboard is an instance
+        pipeline_config.vertex_input_binding_descriptions = {
+            {INSTANCE_BINDING, sizeof(KitBillboardInstance), VK_VERTEX_INPUT_RATE_INSTANCE},
+        };
+        pipeline_config.vertex_input_attribute_descriptions = {
+            {0, INSTANCE_BINDING, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(KitBillboardInstance, position)},
+            {1, INSTANCE_BINDING, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(KitBillboardInstance, color)},
+        };
 
         pipeline_config.render_pass     = render_pass;
         pipeline_config.pipeline_layout = pipeline_layout_;
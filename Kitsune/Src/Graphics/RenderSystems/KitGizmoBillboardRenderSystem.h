@@ -1,7 +1,8 @@
 ﻿#pragma once
-#include "Core/Scene/KitGameObject.h"
+#include "Core/Scene/KitScene.h"
 #include "Graphics/KitCamera.h"
 #include "Graphics/KitEngineDevice.h"
+#include "Graphics/KitGraphicsBuffer.h"
 #include "Graphics/KitPipeline.h"
 #include "KitFrameInfo.h"
 #include "KitRenderSystemBase.h"
@@ -9,12 +10,22 @@
 
 namespace Kitsune
 {
+    // Draws every point light as a camera facing disc with a single instanced draw of a 6 vertex quad.
+    // Prepare packs the position, radius and color of each light into the instance buffer of the frame.
     class KitGizmoBillboardRenderSystem : public KitRenderSystemBase
     {
+        static constexpr uint32_t INSTANCE_BINDING          = 0;
+        static constexpr uint32_t INITIAL_INSTANCE_CAPACITY = 64;
+
+        // Billboards of each frame in flight
+        std::vector<std::unique_ptr<KitGraphicsBuffer>> instance_buffers_;
+        uint32_t                                        billboard_count_ = 0;
+
     public:
         explicit KitGizmoBillboardRenderSystem(KitEngineDevice* device);
 
         void Update(const KitFrameInfo &frame_info, KitGlobalUBO &ubo) override;
+        void Prepare(const KitFrameInfo& frame_info) override;
         void Render(const KitFrameInfo& frame_info) const override;
 
     protected:
@@ -0,0 +1,608 @@
+#include "KitGpuDrivenRenderSystem.h"
+
+#include <algorithm>
+
+#include "Core/KitLogs.h"
+#include "Graphics/KitGeometryArena.h"
+#include "Graphics/KitModel.h"
+#include "Graphics/KitSwapChain.h"
+
+namespace Kitsune
+{
+    namespace
+    {
+        void AddObjectInput(PipelineConfigInfo& config_info, const uint32_t binding)
+        {
+            config_info.vertex_input_binding_descriptions.emplace_back(binding, sizeof(KitGpuObject),
+                                                                       VK_VERTEX_INPUT_RATE_INSTANCE);
+
+            // Same locations as the instance data of KitBasicRenderSystem, the vertex shaders are shared
+            constexpr uint32_t first_location = 4;
+            for (uint32_t column = 0; column < 4; column++)
+            {
+                config_info.vertex_input_attribute_descriptions.emplace_back(
+                    first_location + column, binding, VK_FORMAT_R32G32B32A32_SFLOAT,
+                    offsetof(KitGpuObject, model_matrix) + column * sizeof(glm::vec4));
+
+                config_info.vertex_input_attribute_descriptions.emplace_back(
+                    first_location + 4 + column, binding, VK_FORMAT_R32G32B32A32_SFLOAT,
+                    offsetof(KitGpuObject, normal_matrix) + column * sizeof(glm::vec4));
+            }
+        }
+    }
+
+    KitGpuDrivenRenderSystem::KitGpuDrivenRenderSystem(
+        KitEngineDevice* device):
+        KitRenderSystemBase(device)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, engine_device_->IsMultiDrawIndirectSupported(),
+                   "GPU driven rendering needs multi draw indirect with a first instance");
+
+        KitGraphicsBuffer::Reserve(
+            engine_device_, object_buffer_, sizeof(KitGpuObject), INITIAL_OBJECT_CAPACITY,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        frames_.resize(KitSwapChain::MAX_FRAMES_IN_FLIGHT);
+        for (KitFrameResources& frame : frames_)
+        {
+            ReserveBuffers(frame);
+        }
+
+        if (engine_device_->GetCmdDrawIndexedIndirectCount() == nullptr)
+        {
+            KIT_LOG(LOG_LOW_LEVEL_GRAPHIC, KitLogLevel::LOG_WARNING,
+                    "VK_KHR_draw_indirect_count is not available, every batch draws its full command range");
+        }
+    }
+
+    KitGpuDrivenRenderSystem::~KitGpuDrivenRenderSystem()
+    {
+        vkDestroyPipelineLayout(engine_device_->GetDevice(), cull_pipeline_layout_, nullptr);
+    }
+
+    void KitGpuDrivenRenderSystem::Prepare(const KitFrameInfo& frame_info)
+    {
+        frame_count_++;
+        std::erase_if(retired_buffers_, [this](const KitRetiredBuffer& retired_buffer)
+        {
+            return frame_count_ - retired_buffer.frame > KitSwapChain::MAX_FRAMES_IN_FLIGHT;
+        });
+
+        SyncScene(frame_info.scene);
+
+        // Every record is uploaded again into a larger buffer, the old one stays alive for the frames reading it
+        std::unique_ptr<KitGraphicsBuffer> old_object_buffer = KitGraphicsBuffer::Reserve(
+            engine_device_, object_buffer_, sizeof(KitGpuObject), static_cast<uint32_t>(objects_.size()),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        if (old_object_buffer != nullptr)
+        {
+            retired_buffers_.push_back({std::move(old_object_buffer), frame_count_});
+
+            changed_objects_.resize(objects_.size());
+            for (uint32_t i = 0; i < changed_objects_.size(); i++)
+            {
+                changed_objects_[i] = i;
+            }
+        }
+
+        // Each batch gets a command range as large as its object count
+        batch_offsets_.resize(batches_.size());
+        command_count_ = 0;
+
+        for (uint32_t i = 0; i < batches_.size(); i++)
+        {
+            batches_[i].command_offset = command_count_;
+            batch_offsets_[i]          = command_count_;
+            command_count_ += batches_[i].object_count;
+        }
+
+        KitFrameResources& frame = frames_[frame_info.frame_index];
+        ReserveBuffers(frame);
+
+        if (!batch_offsets_.empty())
+        {
+            frame.batch_offsets->WriteToBuffer(batch_offsets_.data(), batch_offsets_.size() * sizeof(uint32_t));
+            frame.batch_offsets->Flush();
+        }
+
+        stats_.uploaded_object_count = 0;
+        if (!changed_objects_.empty())
+        {
+            UploadObjects(frame_info.command_buffer, frame);
+        }
+
+        Cull(frame_info, frame);
+
+        stats_.object_count        = static_cast<uint32_t>(objects_.size() - free_objects_.size());
+        stats_.indirect_draw_count = static_cast<uint32_t>(std::ranges::count_if(batches_, [](const KitGpuBatch& batch)
+        {
+            return batch.object_count > 0;
+        }));
+    }
+
+    void KitGpuDrivenRenderSystem::Render(const KitFrameInfo& frame_info) const
+    {
+        if (command_count_ == 0)
+        {
+            return;
+        }
+
+        const KitFrameResources& frame = frames_[frame_info.frame_index];
+
+        const VkBuffer     object_buffer = object_buffer_->GetBuffer();
+        const VkDeviceSize offset        = 0;
+        vkCmdBindVertexBuffers(frame_info.command_buffer, OBJECT_BINDING, 1, &object_buffer, &offset);
+
+        const PFN_vkCmdDrawIndexedIndirectCountKHR draw_indexed_indirect_count = engine_device_->GetCmdDrawIndexedIndirectCount();
+        const KitPipeline*                         bound_pipeline              = nullptr;
+
+        for (uint32_t i = 0; i < batches_.size(); i++)
+        {
+            const KitGpuBatch& batch = batches_[i];
+            if (batch.object_count == 0)
+            {
+                continue;
+            }
+
+            const KitPipeline* pipeline = batch.layout == KitVertexLayout::PACKED ? packed_pipeline_.get() : pipeline_.get();
+            if (pipeline != bound_pipeline)
+            {
+                pipeline->Bind(frame_info.command_buffer);
+
+                vkCmdBindDescriptorSets(
+                    frame_info.command_buffer,
+                    VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    pipeline_layout_,
+                    0,
+                    1,
+                    &frame_info.descriptor_set,
+                    0,
+                    nullptr);
+
+                bound_pipeline = pipeline;
+            }
+
+            engine_device_->GetGeometryArena(batch.layout)->Bind(frame_info.command_buffer, batch.page);
+
+            const VkDeviceSize command_offset = batch.command_offset * sizeof(VkDrawIndexedIndirectCommand);
+
+            if (draw_indexed_indirect_count != nullptr)
+            {
+                draw_indexed_indirect_count(
+                    frame_info.command_buffer,
+                    frame.commands->GetBuffer(),
+                    command_offset,
+                    frame.counts->GetBuffer(),
+                    i * sizeof(uint32_t),
+                    batch.object_count,
+                    sizeof(VkDrawIndexedIndirectCommand));
+            }
+            else
+            {
+                vkCmdDrawIndexedIndirect(
+                    frame_info.command_buffer,
+                    frame.commands->GetBuffer(),
+                    command_offset,
+                    batch.object_count,
+                    sizeof(VkDrawIndexedIndirectCommand));
+            }
+        }
+    }
+
+    void KitGpuDrivenRenderSystem::CreatePipelineLayout(VkDescriptorSetLayout descriptor_set_layout)
+    {
+        std::vector<VkDescriptorSetLayout> set_layouts_sets{descriptor_set_layout};
+
+        VkPipelineLayoutCreateInfo create_info{};
+        create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        create_info.setLayoutCount         = set_layouts_sets.size();
+        create_info.pSetLayouts            = set_layouts_sets.data();
+        create_info.pushConstantRangeCount = 0;
+        create_info.pPushConstantRanges    = nullptr;
+
+        VkResult result = vkCreatePipelineLayout(engine_device_->GetDevice(), &create_info, nullptr, &pipeline_layout_);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create pipeline layout!");
+
+        // Objects, batch offsets, commands and counts
+        cull_set_layout_ = KitDescriptorSetLayout::KitDescriptorSetLayoutBuilder(engine_device_)
+                           .AddBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                           .AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                           .AddBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                           .AddBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)
+                           .Build();
+
+        cull_descriptor_pool_ = KitDescriptorPool::KitDescriptorPoolBuilder(engine_device_)
+                                .SetMaxSets(KitSwapChain::MAX_FRAMES_IN_FLIGHT)
+                                .AddPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 * KitSwapChain::MAX_FRAMES_IN_FLIGHT)
+                                .Build();
+
+        for (KitFrameResources& frame : frames_)
+        {
+            const bool is_allocated = cull_descriptor_pool_->AllocateDescriptor(
+                cull_set_layout_->GetDescriptorSetLayout(), frame.descriptor_set);
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, is_allocated, "Fail to allocate the culling descriptor set!");
+        }
+
+        VkPushConstantRange push_constant_range;
+        push_constant_range.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        push_constant_range.offset     = 0;
+        push_constant_range.size       = sizeof(KitCullPushConstants);
+
+        const VkDescriptorSetLayout cull_set_layout = cull_set_layout_->GetDescriptorSetLayout();
+
+        VkPipelineLayoutCreateInfo cull_create_info{};
+        cull_create_info.sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        cull_create_info.setLayoutCount         = 1;
+        cull_create_info.pSetLayouts            = &cull_set_layout;
+        cull_create_info.pushConstantRangeCount = 1;
+        cull_create_info.pPushConstantRanges    = &push_constant_range;
+
+        result = vkCreatePipelineLayout(engine_device_->GetDevice(), &cull_create_info, nullptr, &cull_pipeline_layout_);
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, result == VK_SUCCESS, "Fail to create culling pipeline layout!");
+    }
+
+    void KitGpuDrivenRenderSystem::CreatePipeline(VkRenderPass render_pass)
+    {
+        KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, pipeline_layout_ != nullptr, "Pipeline layouts do not exist at pipeline creation!");
+
+        PipelineConfigInfo pipeline_config{};
+        KitPipeline::DefaultPipelineConfigInfo(pipeline_config);
+        AddObjectInput(pipeline_config, OBJECT_BINDING);
+
+        pipeline_config.render_pass     = render_pass;
+        pipeline_config.pipeline_layout = pipeline_layout_;
+
+        pipeline_ = std::make_unique<KitPipeline>(
+            engine_device_,
+            "Shader/Simple3DVert.spv",
+            "Shader/Simple3DFrag.spv",
+            pipeline_config);
+
+        PipelineConfigInfo packed_pipeline_config{};
+        KitPipeline::DefaultPipelineConfigInfo(packed_pipeline_config);
+
+        packed_pipeline_config.render_pass                         = render_pass;
+        packed_pipeline_config.pipeline_layout                     = pipeline_layout_;
+        packed_pipeline_config.vertex_input_binding_descriptions   = KitPackedVertex::GetBindingDescriptions();
+        packed_pipeline_config.vertex_input_attribute_descriptions = KitPackedVertex::GetAttributeDescriptions();
+        AddObjectInput(packed_pipeline_config, OBJECT_BINDING);
+
+        packed_pipeline_ = std::make_unique<KitPipeline>(
+            engine_device_,
+            "Shader/Simple3DPackedVert.spv",
+            "Shader/Simple3DFrag.spv",
+            packed_pipeline_config);
+
+        cull_pipeline_ = std::make_unique<KitComputePipeline>(engine_device_, "Shader/GpuCullComp.spv", cull_pipeline_layout_);
+    }
+
+    void KitGpuDrivenRenderSystem::SyncScene(KitScene& scene)
+    {
+        // The first frame reports every model entity already in the scene
+        if (!scene.IsTrackingModelChanges())
+        {
+            scene.SetModelChangeTracking(true);
+        }
+
+        // Removals first, a handle index freed this frame may already belong to a changed entity
+        for (const KitEntityHandle handle : scene.GetRemovedModels())
+        {
+            RemoveEntity(handle);
+        }
+
+        for (const flecs::entity entity : scene.GetChangedModels())
+        {
+            if (entity.is_alive())
+            {
+                WriteEntity(scene, entity);
+            }
+        }
+
+        scene.ClearModelChanges();
+    }
+
+    void KitGpuDrivenRenderSystem::WriteEntity(const KitScene& scene, const flecs::entity entity)
+    {
+        const KitEntityHandle    handle          = KitScene::GetHandle(entity);
+        const KitWorldTransform* world_transform = entity.get<KitWorldTransform>();
+        const KitModelComponent* model_component = entity.get<KitModelComponent>();
+        const KitModel*          model           = model_component != nullptr ? scene.GetModel(model_component->model) : nullptr;
+
+        if (handle.IsNull() || world_transform == nullptr || model == nullptr)
+        {
+            return;
+        }
+
+        if (handle.GetIndex() >= entities_.size())
+        {
+            entities_.resize(handle.GetIndex() + 1);
+        }
+
+        KitGpuEntity& gpu_entity = entities_[handle.GetIndex()];
+        if (gpu_entity.handle != handle)
+        {
+            RemoveEntity(gpu_entity.handle);
+            gpu_entity.handle = handle;
+        }
+
+        // Models reloaded in place can change their mesh count
+        const std::vector<KitMesh>& meshes = model->GetMeshes();
+        while (gpu_entity.objects.size() < meshes.size())
+        {
+            gpu_entity.objects.push_back(AllocateObject());
+        }
+
+        while (gpu_entity.objects.size() > meshes.size())
+        {
+            FreeObject(gpu_entity.objects.back());
+            gpu_entity.objects.pop_back();
+        }
+
+        const glm::mat4& model_matrix = world_transform->model_matrix;
+
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            const KitMesh&         mesh  = meshes[i];
+            const KitSubmeshRange& range = mesh.GetRange();
+
+            KitGpuObject object{};
+            if (range.index_count > 0)
+            {
+                const KitBoundingSphere sphere = mesh.GetBounds().sphere.Transform(model_matrix);
+
+                // Packed positions are in mesh bounds space, the dequantize is folded into the model matrix
+                object.model_matrix  = mesh.GetLayout() == KitVertexLayout::PACKED ? model_matrix * mesh.GetDequantizeMatrix()
+                                                                                   : model_matrix;
+                object.normal_matrix = world_transform->normal_matrix;
+                object.sphere        = glm::vec4(sphere.center, sphere.radius);
+                object.index_count   = range.index_count;
+                object.first_index   = range.first_index;
+                object.vertex_offset = static_cast<int32_t>(range.vertex_offset);
+                object.batch         = GetBatch(mesh.GetLayout(), range.page);
+            }
+
+            SetObject(gpu_entity.objects[i], object);
+        }
+    }
+
+    void KitGpuDrivenRenderSystem::RemoveEntity(const KitEntityHandle handle)
+    {
+        if (handle.IsNull() || handle.GetIndex() >= entities_.size() || entities_[handle.GetIndex()].handle != handle)
+        {
+            return;
+        }
+
+        KitGpuEntity& gpu_entity = entities_[handle.GetIndex()];
+        for (const uint32_t object : gpu_entity.objects)
+        {
+            FreeObject(object);
+        }
+
+        gpu_entity = {};
+    }
+
+    uint32_t KitGpuDrivenRenderSystem::AllocateObject()
+    {
+        if (free_objects_.empty())
+        {
+            objects_.emplace_back();
+            return static_cast<uint32_t>(objects_.size()) - 1;
+        }
+
+        const uint32_t object = free_objects_.back();
+        free_objects_.pop_back();
+
+        return object;
+    }
+
+    void KitGpuDrivenRenderSystem::FreeObject(const uint32_t object)
+    {
+        // The cleared record is uploaded like any other, the culling shader skips it
+        SetObject(object, {});
+        free_objects_.push_back(object);
+    }
+
+    void KitGpuDrivenRenderSystem::SetObject(const uint32_t object, const KitGpuObject& data)
+    {
+        KitGpuObject& current = objects_[object];
+
+        if (current.index_count > 0)
+        {
+            batches_[current.batch].object_count--;
+        }
+
+        if (data.index_count > 0)
+        {
+            batches_[data.batch].object_count++;
+        }
+
+        current = data;
+        changed_objects_.push_back(object);
+    }
+
+    uint32_t KitGpuDrivenRenderSystem::GetBatch(const KitVertexLayout layout, const uint32_t page)
+    {
+        const uint64_t key = static_cast<uint64_t>(layout) << 32 | page;
+
+        const auto [it, is_new] = batch_of_page_.try_emplace(key, static_cast<uint32_t>(batches_.size()));
+        if (is_new)
+        {
+            batches_.push_back({layout, page});
+        }
+
+        return it->second;
+    }
+
+    void KitGpuDrivenRenderSystem::ReserveBuffers(KitFrameResources& frame)
+    {
+        // Only used by this frame's command buffer, its fence was waited on before recording
+        const uint32_t batch_capacity = std::max(static_cast<uint32_t>(batches_.size()), INITIAL_BATCH_CAPACITY);
+
+        KitGraphicsBuffer::Reserve(
+            engine_device_, frame.staging, sizeof(KitGpuObject),
+            std::max(static_cast<uint32_t>(changed_objects_.size()), INITIAL_OBJECT_CAPACITY),
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+        KitGraphicsBuffer::Reserve(
+            engine_device_, frame.batch_offsets, sizeof(uint32_t), batch_capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+
+        KitGraphicsBuffer::Reserve(
+            engine_device_, frame.commands, sizeof(VkDrawIndexedIndirectCommand),
+            std::max(command_count_, INITIAL_OBJECT_CAPACITY),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+        KitGraphicsBuffer::Reserve(
+            engine_device_, frame.counts, sizeof(uint32_t), batch_capacity,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    void KitGpuDrivenRenderSystem::UploadObjects(const VkCommandBuffer command_buffer, const KitFrameResources& frame)
+    {
+        // An entity changed twice in a frame lists its objects twice
+        std::ranges::sort(changed_objects_);
+        const auto duplicates = std::ranges::unique(changed_objects_);
+        changed_objects_.erase(duplicates.begin(), duplicates.end());
+
+        // Consecutive records become one copy region
+        auto* staged_objects = static_cast<KitGpuObject*>(frame.staging->GetMappedMemory());
+        copy_regions_.clear();
+
+        for (uint32_t i = 0; i < changed_objects_.size(); i++)
+        {
+            const uint32_t object = changed_objects_[i];
+            staged_objects[i]     = objects_[object];
+
+            if (i > 0 && object == changed_objects_[i - 1] + 1)
+            {
+                copy_regions_.back().size += sizeof(KitGpuObject);
+                continue;
+            }
+
+            copy_regions_.push_back({i * sizeof(KitGpuObject), object * sizeof(KitGpuObject), sizeof(KitGpuObject)});
+        }
+
+        frame.staging->Flush();
+
+        // The previous frames may still read the records being overwritten
+        vkCmdPipelineBarrier(
+            command_buffer,
+            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            0,
+            0,
+            nullptr,
+            0,
+            nullptr,
+            0,
+            nullptr);
+
+        vkCmdCopyBuffer(command_buffer, frame.staging->GetBuffer(), object_buffer_->GetBuffer(),
+                        static_cast<uint32_t>(copy_regions_.size()), copy_regions_.data());
+
+        stats_.uploaded_object_count = static_cast<uint32_t>(changed_objects_.size());
+        changed_objects_.clear();
+    }
+
+    void KitGpuDrivenRenderSystem::Cull(const KitFrameInfo& frame_info, KitFrameResources& frame) const
+    {
+        const VkCommandBuffer command_buffer = frame_info.command_buffer;
+
+        if (!batches_.empty())
+        {
+            vkCmdFillBuffer(command_buffer, frame.counts->GetBuffer(), 0, batches_.size() * sizeof(uint32_t), 0);
+        }
+
+        // Without a GPU count every command of a batch is drawn, the ones left unwritten must have no instances
+        if (engine_device_->GetCmdDrawIndexedIndirectCount() == nullptr && command_count_ > 0)
+        {
+            vkCmdFillBuffer(command_buffer, frame.commands->GetBuffer(), 0,
+                            command_count_ * sizeof(VkDrawIndexedIndirectCommand), 0);
+        }
+
+        VkMemoryBarrier transfer_barrier{};
+        transfer_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        transfer_barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        transfer_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            command_buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
+            0,
+            1,
+            &transfer_barrier,
+            0,
+            nullptr,
+            0,
+            nullptr);
+
+        if (objects_.empty())
+        {
+            return;
+        }
+
+        // The object buffer may have been replaced, the set is rewritten every frame
+        VkDescriptorBufferInfo object_info       = object_buffer_->DescriptorInfo();
+        VkDescriptorBufferInfo batch_offset_info = frame.batch_offsets->DescriptorInfo();
+        VkDescriptorBufferInfo command_info      = frame.commands->DescriptorInfo();
+        VkDescriptorBufferInfo count_info        = frame.counts->DescriptorInfo();
+
+        KitDescriptorWriter(*cull_set_layout_, *cull_descriptor_pool_)
+            .WriteBuffer(0, &object_info)
+            .WriteBuffer(1, &batch_offset_info)
+            .WriteBuffer(2, &command_info)
+            .WriteBuffer(3, &count_info)
+            .Overwrite(frame.descriptor_set);
+
+        KitCullPushConstants push_constants{};
+        push_constants.object_count = static_cast<uint32_t>(objects_.size());
+
+        const KitFrustum frustum = frame_info.camera->GetFrustum();
+        std::copy(frustum.planes.begin(), frustum.planes.end(), push_constants.planes.begin());
+
+        cull_pipeline_->Bind(command_buffer);
+
+        vkCmdBindDescriptorSets(
+            command_buffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            cull_pipeline_layout_,
+            0,
+            1,
+            &frame.descriptor_set,
+            0,
+            nullptr);
+
+        vkCmdPushConstants(
+            command_buffer,
+            cull_pipeline_layout_,
+            VK_SHADER_STAGE_COMPUTE_BIT,
+            0,
+            sizeof(push_constants),
+            &push_constants);
+
+        vkCmdDispatch(command_buffer, (push_constants.object_count + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+        VkMemoryBarrier cull_barrier{};
+        cull_barrier.sType         = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        cull_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        cull_barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+        vkCmdPipelineBarrier(
+            command_buffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+            0,
+            1,
+            &cull_barrier,
+            0,
+            nullptr,
+            0,
+            nullptr);
+    }
+} // Kitsune
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+#include "KitRenderSystemBase.h"
+#include "Graphics/KitDescriptor.h"
+#include "Graphics/KitGraphicsBuffer.h"
+
+namespace Kitsune
+{
+    enum class KitVertexLayout : uint32_t;
+
+    // std430 mirror of GpuObject in GpuCullComp.glsl, one per mesh of a model entity
+    struct KitGpuObject
+    {
+        glm::mat4 model_matrix{1.f};
+        glm::mat4 normal_matrix{1.f};
+        glm::vec4 sphere{0.f};       // World space center and radius
+        uint32_t  index_count   = 0; // 0 marks a free slot
+        uint32_t  first_index   = 0;
+        int32_t   vertex_offset = 0;
+        uint32_t  batch         = 0;
+    };
+
+    static_assert(sizeof(KitGpuObject) == 160, "KitGpuObject must match the std430 layout of GpuObject");
+
+    struct KitGpuDrivenStats
+    {
+        uint32_t object_count          = 0;
+        uint32_t indirect_draw_count   = 0;
+        uint32_t uploaded_object_count = 0;
+    };
+
+    // Keeps every model mesh of the scene on the GPU and lets a compute shader cull them and write the draw commands,
+    // the CPU cost of a frame follows the number of objects that changed rather than the number drawn.
+    // The object records live in one device local buffer, each frame only copies the records of the entities the scene
+    // reports as changed. GpuCullComp tests them against the frustum and appends a VkDrawIndexedIndirectCommand for each
+    // visible one to the range of its batch, the objects sharing a geometry arena page. Each batch is one indirect draw,
+    // its count read from the GPU with VK_KHR_draw_indirect_count when the device has it. Without it every command of
+    // the batch is drawn, the commands are cleared beforehand so the unused ones draw nothing.
+    // A hot reload frees the arena ranges of the old meshes, the scene reports every entity of the reloaded model as
+    // changed so their records are rewritten in the frame of the swap.
+    // Meshes without indices are not drawn.
+    class KitGpuDrivenRenderSystem : public KitRenderSystemBase
+    {
+        static constexpr uint32_t OBJECT_BINDING          = 1;
+        static constexpr uint32_t WORKGROUP_SIZE          = 64;
+        static constexpr uint32_t INITIAL_OBJECT_CAPACITY = 1024;
+        static constexpr uint32_t INITIAL_BATCH_CAPACITY  = 16;
+
+        struct KitCullPushConstants
+        {
+            std::array<glm::vec4, 6> planes{};
+            uint32_t                 object_count = 0;
+        };
+
+        // Objects of one vertex layout in one arena page, they share their vertex and index buffers
+        struct KitGpuBatch
+        {
+            KitVertexLayout layout;
+            uint32_t        page           = 0;
+            uint32_t        object_count   = 0;
+            uint32_t        command_offset = 0;
+        };
+
+        // Object slots of a model entity, one per mesh
+        struct KitGpuEntity
+        {
+            KitEntityHandle       handle;
+            std::vector<uint32_t> objects;
+        };
+
+        struct KitFrameResources
+        {
+            std::unique_ptr<KitGraphicsBuffer> staging;
+            std::unique_ptr<KitGraphicsBuffer> batch_offsets;
+            std::unique_ptr<KitGraphicsBuffer> commands;
+            std::unique_ptr<KitGraphicsBuffer> counts;
+            VkDescriptorSet                    descriptor_set = VK_NULL_HANDLE;
+        };
+
+        // Buffers shared by every frame in flight outlive the frames that may still read them
+        struct KitRetiredBuffer
+        {
+            std::unique_ptr<KitGraphicsBuffer> buffer;
+            uint64_t                           frame = 0;
+        };
+
+        std::unique_ptr<KitPipeline> packed_pipeline_ = nullptr;
+
+        std::unique_ptr<KitDescriptorSetLayout> cull_set_layout_;
+        std::unique_ptr<KitDescriptorPool>      cull_descriptor_pool_;
+        std::unique_ptr<KitComputePipeline>     cull_pipeline_;
+        VkPipelineLayout                        cull_pipeline_layout_ = nullptr;
+
+        // CPU copy of every record, freed slots are reused before the buffer grows
+        std::vector<KitGpuObject>          objects_;
+        std::vector<uint32_t>              free_objects_;
+        std::vector<uint32_t>              changed_objects_;
+        std::unique_ptr<KitGraphicsBuffer> object_buffer_;
+
+        std::vector<KitRetiredBuffer> retired_buffers_;
+        uint64_t                      frame_count_ = 0;
+
+        // Indexed by entity handle index
+        std::vector<KitGpuEntity> entities_;
+
+        std::vector<KitGpuBatch>               batches_;
+        std::unordered_map<uint64_t, uint32_t> batch_of_page_;
+        uint32_t                               command_count_ = 0;
+
+        std::vector<KitFrameResources> frames_;
+        KitGpuDrivenStats              stats_;
+
+        // Scratch reused every frame
+        std::vector<uint32_t>     batch_offsets_;
+        std::vector<VkBufferCopy> copy_regions_;
+
+    public:
+        explicit KitGpuDrivenRenderSystem(KitEngineDevice* device);
+        ~KitGpuDrivenRenderSystem() override;
+
+        // Records the uploads and the culling dispatch, the frame's command buffer is still outside the render pass
+        void Prepare(const KitFrameInfo& frame_info) override;
+        void Render(const KitFrameInfo& frame_info) const override;
+
+        KIT_NODISCARD const KitGpuDrivenStats& GetStats() const { return stats_; }
+
+    protected:
+        void CreatePipelineLayout(VkDescriptorSetLayout descriptor_set_layout) override;
+        void CreatePipeline(VkRenderPass render_pass) override;
+
+    private:
+        // Applies the model entities the scene created, moved or destroyed since the last frame
+        void SyncScene(KitScene& scene);
+        void WriteEntity(const KitScene& scene, flecs::entity entity);
+        void RemoveEntity(KitEntityHandle handle);
+
+        uint32_t AllocateObject();
+        void     FreeObject(uint32_t object);
+        void     SetObject(uint32_t object, const KitGpuObject& data);
+        uint32_t GetBatch(KitVertexLayout layout, uint32_t page);
+
+        void ReserveBuffers(KitFrameResources& frame);
+        void UploadObjects(VkCommandBuffer command_buffer, const KitFrameResources& frame);
+        void Cull(const KitFrameInfo& frame_info, KitFrameResources& frame) const;
+    };
+} // Kitsune
@@ -41,8 +41,25 @@ namespace Kitsune
         {
         };
 
+        // Runs after culling, before the render pass begins, to upload per frame data built from the visible meshes
+        virtual void Prepare(const KitFrameInfo& frame_info)
+        {
+        };
+
         virtual void Render(const KitFrameInfo& frame_info) const = 0;
 
+        // Parts Render can be split into, each recorded into its own secondary command buffer, possibly on another thread
+        KIT_NODISCARD virtual uint32_t GetRenderChunkCount(const uint32_t max_chunk_count) const
+        {
+            return 1;
+        }
+
+        // Records a disjoint share of the draws, chunks of one frame may run concurrently
+        virtual void RenderChunk(const KitFrameInfo& frame_info, const uint32_t chunk, const uint32_t chunk_count) const
+        {
+            Render(frame_info);
+        }
+
     protected:
         virtual void CreatePipelineLayout(const VkDescriptorSetLayout descriptor_set_layout) = 0;
         virtual void CreatePipeline(const VkRenderPass render_pass) = 0;
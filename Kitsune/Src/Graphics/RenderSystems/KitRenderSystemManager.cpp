@@ -0,0 +1,66 @@
+#include "KitRenderSystemManager.h"
+
+#include "Core/KitLogs.h"
+
+namespace Kitsune
+{
+    void KitRenderSystemManager::Record(const KitFrameInfo& frame_info, KitCommandRecorder& recorder, KitJobSystem* job_system)
+    {
+        const uint32_t participant_count = job_system != nullptr ? recorder.GetParticipantCount() : 1;
+
+        record_tasks_.clear();
+        for (const auto& system : render_systems_)
+        {
+            const uint32_t chunk_count = system->GetRenderChunkCount(participant_count);
+            for (uint32_t chunk = 0; chunk < chunk_count; chunk++)
+            {
+                record_tasks_.push_back({system.get(), chunk, chunk_count});
+            }
+        }
+
+        // Written by task index, the execution order does not depend on which thread recorded what
+        secondary_command_buffers_.resize(record_tasks_.size());
+
+        const auto record = [this, &frame_info, &recorder](const uint32_t task_index, const uint32_t participant)
+        {
+            const KitRecordTask&  task           = record_tasks_[task_index];
+            const VkCommandBuffer command_buffer = recorder.Begin(participant);
+
+            const KitFrameInfo chunk_frame_info{
+                frame_info.frame_index,
+                frame_info.frame_time,
+                command_buffer,
+                frame_info.camera,
+                frame_info.descriptor_set,
+                frame_info.scene,
+                frame_info.visible_meshes};
+
+            task.system->RenderChunk(chunk_frame_info, task.chunk, task.chunk_count);
+
+            recorder.End(command_buffer);
+            secondary_command_buffers_[task_index] = command_buffer;
+        };
+
+        if (job_system == nullptr)
+        {
+            for (uint32_t i = 0; i < record_tasks_.size(); i++)
+            {
+                record(i, 0);
+            }
+        }
+        else
+        {
+            KIT_ASSERT(LOG_LOW_LEVEL_GRAPHIC, job_system->GetParticipantCount() <= recorder.GetParticipantCount(),
+                       "Command recorder has {} pools for {} job system participants", recorder.GetParticipantCount(),
+                       job_system->GetParticipantCount());
+
+            job_system->ParallelFor(static_cast<uint32_t>(record_tasks_.size()), record);
+        }
+
+        if (!secondary_command_buffers_.empty())
+        {
+            vkCmdExecuteCommands(frame_info.command_buffer, static_cast<uint32_t>(secondary_command_buffers_.size()),
+                                 secondary_command_buffers_.data());
+        }
+    }
+} // Kitsune
@@ -3,6 +3,8 @@
 #include <vector>
 
 #include "KitRenderSystemBase.h"
+#include "Core/KitJobSystem.h"
+#include "Graphics/KitCommandRecorder.h"
 
 namespace Kitsune
 {
@@ -10,9 +12,21 @@ namespace Kitsune
 
     class KitRenderSystemManager
     {
+        // One secondary command buffer each
+        struct KitRecordTask
+        {
+            const KitRenderSystemBase* system;
+            uint32_t                   chunk;
+            uint32_t                   chunk_count;
+        };
+
         KitEngineDevice* engine_device_;
         std::vector<std::unique_ptr<KitRenderSystemBase>> render_systems_;
 
+        // Scratch reused every frame
+        std::vector<KitRecordTask>   record_tasks_;
+        std::vector<VkCommandBuffer> secondary_command_buffers_;
+
     public:
         explicit KitRenderSystemManager(KitEngineDevice* device):
             engine_device_(device)
@@ -43,6 +57,14 @@ namespace Kitsune
             }
         }
 
+        void Prepare(const KitFrameInfo& frame_info) const
+        {
+            for (const auto& system : render_systems_)
+            {
+                system->Prepare(frame_info);
+            }
+        }
+
         void Render(const KitFrameInfo& frame_info) const
         {
             for (const auto& system : render_systems_)
@@ -50,5 +72,11 @@ namespace Kitsune
                 system->Render(frame_info);
             }
         }
+
+        // Records the render systems into secondary command buffers on the job system, a system with many draws split
+        // into several chunks, and executes them from the frame's command buffer in registration order. The render pass
+        // must have begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS. Records on the calling thread alone
+        // without a job system.
+        void Record(const KitFrameInfo& frame_info, KitCommandRecorder& recorder, KitJobSystem* job_system = nullptr);
     };
 }
@@ -0,0 +1,176 @@
+// KitBvh off thread rebuilds with proxies destroyed, created and moved between CaptureBuild() and ApplyBuild(). CPU only.
+
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "Core/Scene/KitBvh.h"
+#include "KitTestUtils.h"
+
+namespace
+{
+    using namespace Kitsune;
+
+    const KitAabb WORLD_AABB = {glm::vec3(-1e9f), glm::vec3(1e9f)};
+
+    class KitRandomBoxes
+    {
+        std::mt19937                          engine_;
+        std::uniform_real_distribution<float> position_{0.f, 1000.f};
+        std::uniform_real_distribution<float> extent_{0.5f, 3.f};
+
+    public:
+        explicit KitRandomBoxes(const uint32_t seed) : engine_(seed) {}
+
+        KitAabb Next()
+        {
+            const glm::vec3 center(position_(engine_), position_(engine_), position_(engine_));
+            const glm::vec3 extent(extent_(engine_));
+            return {center - extent, center + extent};
+        }
+    };
+
+    // Proxy ids to the box they were last given and their user data
+    struct KitLiveProxy
+    {
+        KitAabb  aabb;
+        uint64_t user_data = 0;
+    };
+
+    void CheckTree(const KitBvh& bvh, const std::map<int32_t, KitLiveProxy>& live)
+    {
+        KIT_TEST_CHECK(bvh.Validate());
+        KIT_TEST_CHECK(bvh.GetProxyCount() == live.size());
+
+        std::set<int32_t> found;
+        bvh.Query(WORLD_AABB, [&found](const int32_t proxy) { found.insert(proxy); });
+        KIT_TEST_CHECK(found.size() == live.size());
+
+        for (const auto& [proxy, expected] : live)
+        {
+            KIT_TEST_CHECK(found.contains(proxy));
+            KIT_TEST_CHECK(bvh.GetFatAabb(proxy).Contains(expected.aabb));
+            KIT_TEST_CHECK(bvh.GetUserData(proxy) == expected.user_data);
+        }
+
+        // The rotations keep the height within about 1.44 * log2(leaves)
+        if (!live.empty())
+        {
+            const double bound = 2.0 * std::log2(static_cast<double>(live.size())) + 2.0;
+            KIT_TEST_CHECK(bvh.GetHeight() <= bound);
+        }
+    }
+
+    void CheckApplyAfterChanges(const uint32_t count)
+    {
+        KitRandomBoxes                  boxes(count);
+        KitBvh                          bvh;
+        std::vector<int32_t>            proxies;
+        std::map<int32_t, KitLiveProxy> live;
+
+        uint64_t next_user_data = 0;
+        auto create = [&]()
+        {
+            const KitAabb aabb  = boxes.Next();
+            const int32_t proxy = bvh.CreateProxy(aabb, next_user_data);
+            live[proxy]         = {aabb, next_user_data++};
+            return proxy;
+        };
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            proxies.push_back(create());
+        }
+        CheckTree(bvh, live);
+
+        KitBvh::KitBvhBuild build = bvh.CaptureBuild();
+        KitBvh::Build(build);
+
+        // Destroyed ones free their nodes first, so the created ones reuse captured leaf slots
+        for (uint32_t i = 0; i < count; i += 4)
+        {
+            bvh.DestroyProxy(proxies[i]);
+            live.erase(proxies[i]);
+        }
+        for (uint32_t i = 0; i < count / 8 + 1; i++)
+        {
+            create();
+        }
+        for (auto& [proxy, expected] : live)
+        {
+            if (proxy % 5 == 0)
+            {
+                expected.aabb = boxes.Next();
+                bvh.MoveProxy(proxy, expected.aabb);
+            }
+        }
+
+        bvh.ApplyBuild(build);
+        CheckTree(bvh, live);
+
+        // The applied tree keeps working with later changes
+        for (auto& [proxy, expected] : live)
+        {
+            if (proxy % 3 == 0)
+            {
+                expected.aabb = boxes.Next();
+                bvh.MoveProxy(proxy, expected.aabb);
+            }
+        }
+        create();
+        CheckTree(bvh, live);
+    }
+
+    void CheckApplyAfterDestroyingAll()
+    {
+        KitRandomBoxes       boxes(7);
+        KitBvh               bvh;
+        std::vector<int32_t> proxies;
+        for (uint64_t i = 0; i < 16; i++)
+        {
+            proxies.push_back(bvh.CreateProxy(boxes.Next(), i));
+        }
+
+        KitBvh::KitBvhBuild build = bvh.CaptureBuild();
+        KitBvh::Build(build);
+
+        for (const int32_t proxy : proxies)
+        {
+            bvh.DestroyProxy(proxy);
+        }
+
+        bvh.ApplyBuild(build);
+        CheckTree(bvh, {});
+        KIT_TEST_CHECK(bvh.GetHeight() == 0);
+    }
+
+    void CheckEmptyTree()
+    {
+        KitBvh bvh;
+        CheckTree(bvh, {});
+
+        KitBvh::KitBvhBuild build = bvh.CaptureBuild();
+        KitBvh::Build(build);
+        bvh.ApplyBuild(build);
+        CheckTree(bvh, {});
+
+        bvh.Rebuild();
+        CheckTree(bvh, {});
+    }
+}
+
+int main()
+{
+    CheckEmptyTree();
+    CheckApplyAfterDestroyingAll();
+
+    for (const uint32_t count : {1u, 2u, 10u, 1000u})
+    {
+        CheckApplyAfterChanges(count);
+    }
+
+    return KitTest::Finish();
+}
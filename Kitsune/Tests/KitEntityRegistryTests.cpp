@@ -0,0 +1,188 @@
+// KitEntityRegistry handle creation and validation, from several threads and up to a full registry. CPU only.
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "Core/KitLogs.h"
+#include "Core/Scene/KitEntityRegistry.h"
+#include "KitTestUtils.h"
+
+namespace
+{
+    using namespace Kitsune;
+
+    constexpr uint32_t THREAD_COUNT = 8;
+    constexpr uint32_t ROUND_COUNT  = 50;
+    constexpr uint32_t BATCH_SIZE   = 256;
+
+    void CheckStaleHandles()
+    {
+        KitEntityRegistry registry;
+
+        KIT_TEST_CHECK(!registry.IsValid(KitEntityHandle{}));
+        KIT_TEST_CHECK(!registry.IsValid(KitEntityHandle::Make(0, 0)));
+
+        const KitEntityHandle first = registry.Create();
+        KIT_TEST_CHECK(!first.IsNull());
+        KIT_TEST_CHECK(registry.IsValid(first));
+        KIT_TEST_CHECK(!registry.IsValid(KitEntityHandle::Make(first.GetIndex() + 1, 0)));
+
+        registry.Destroy(first);
+        KIT_TEST_CHECK(!registry.IsValid(first));
+        KIT_TEST_CHECK(registry.GetAliveCount() == 0);
+
+        // The slot comes back with the next generation, the old handle keeps failing
+        const KitEntityHandle second = registry.Create();
+        KIT_TEST_CHECK(second.GetIndex() == first.GetIndex());
+        KIT_TEST_CHECK(second.GetGeneration() == first.GetGeneration() + 1);
+        KIT_TEST_CHECK(registry.IsValid(second));
+        KIT_TEST_CHECK(!registry.IsValid(first));
+
+        // Bulk creation takes the freed slot before fresh ones
+        registry.Destroy(second);
+
+        KitEntityHandle handles[4];
+        registry.Create(handles);
+        KIT_TEST_CHECK(handles[0].GetIndex() == first.GetIndex());
+        KIT_TEST_CHECK(!registry.IsValid(second));
+        for (const KitEntityHandle handle : handles)
+        {
+            KIT_TEST_CHECK(registry.IsValid(handle));
+        }
+        KIT_TEST_CHECK(registry.GetAliveCount() == 4);
+
+        registry.Destroy(handles);
+        for (const KitEntityHandle handle : handles)
+        {
+            KIT_TEST_CHECK(!registry.IsValid(handle));
+        }
+        KIT_TEST_CHECK(registry.GetAliveCount() == 0);
+    }
+
+    void CheckConcurrentCreateDestroy()
+    {
+        KitEntityRegistry registry;
+
+        std::vector<std::vector<KitEntityHandle>> kept(THREAD_COUNT);
+        std::vector<uint32_t>                     failures(THREAD_COUNT, 0);
+
+        // Every thread creates one by one and in bulk, destroys part of it and keeps the rest
+        std::vector<std::thread> threads;
+        for (uint32_t thread_index = 0; thread_index < THREAD_COUNT; thread_index++)
+        {
+            threads.emplace_back([&registry, &kept, &failures, thread_index]()
+            {
+                std::vector<KitEntityHandle> singles(BATCH_SIZE);
+                std::vector<KitEntityHandle> batch(BATCH_SIZE);
+
+                for (uint32_t round = 0; round < ROUND_COUNT; round++)
+                {
+                    for (KitEntityHandle& handle : singles)
+                    {
+                        handle = registry.Create();
+                    }
+                    registry.Create(batch);
+
+                    for (uint32_t i = 0; i < BATCH_SIZE; i++)
+                    {
+                        failures[thread_index] += !registry.IsValid(singles[i]) + !registry.IsValid(batch[i]);
+                    }
+
+                    for (uint32_t i = 0; i < BATCH_SIZE; i++)
+                    {
+                        if (i % 2 == 0)
+                        {
+                            registry.Destroy(singles[i]);
+                        }
+                        else
+                        {
+                            kept[thread_index].push_back(singles[i]);
+                        }
+                    }
+
+                    kept[thread_index].push_back(batch.back());
+                    registry.Destroy(std::span<const KitEntityHandle>(batch).first(BATCH_SIZE - 1));
+
+                    for (uint32_t i = 0; i < BATCH_SIZE; i += 2)
+                    {
+                        failures[thread_index] += registry.IsValid(singles[i]);
+                    }
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        size_t           kept_count = 0;
+        std::vector<int> owners(KitEntityRegistry::MAX_ENTITIES, 0);
+        for (uint32_t thread_index = 0; thread_index < THREAD_COUNT; thread_index++)
+        {
+            KIT_TEST_CHECK(failures[thread_index] == 0);
+
+            for (const KitEntityHandle handle : kept[thread_index])
+            {
+                KIT_TEST_CHECK(registry.IsValid(handle));
+                owners[handle.GetIndex()]++;
+            }
+            kept_count += kept[thread_index].size();
+        }
+
+        // No slot was handed out twice
+        for (const int owner_count : owners)
+        {
+            KIT_TEST_CHECK(owner_count <= 1);
+        }
+        KIT_TEST_CHECK(registry.GetAliveCount() == kept_count);
+    }
+
+    void CheckFullRegistry()
+    {
+        KitEntityRegistry registry;
+
+        std::vector<KitEntityHandle> handles(KitEntityRegistry::MAX_ENTITIES);
+        registry.Create(handles);
+        KIT_TEST_CHECK(registry.GetAliveCount() == KitEntityRegistry::MAX_ENTITIES);
+        KIT_TEST_CHECK(registry.IsValid(handles.front()));
+        KIT_TEST_CHECK(registry.IsValid(handles.back()));
+
+        KIT_TEST_CHECK(registry.Create().IsNull());
+
+        KitEntityHandle overflow[4];
+        registry.Create(overflow);
+        for (const KitEntityHandle handle : overflow)
+        {
+            KIT_TEST_CHECK(handle.IsNull());
+        }
+        KIT_TEST_CHECK(registry.GetAliveCount() == KitEntityRegistry::MAX_ENTITIES);
+
+        // A freed slot is still handed out, the fresh part of a bulk creation stays null
+        registry.Destroy(handles[42]);
+        KitEntityHandle partial[2];
+        registry.Create(partial);
+        KIT_TEST_CHECK(partial[0].GetIndex() == 42);
+        KIT_TEST_CHECK(registry.IsValid(partial[0]));
+        KIT_TEST_CHECK(partial[1].IsNull());
+        KIT_TEST_CHECK(!registry.IsValid(handles[42]));
+        KIT_TEST_CHECK(registry.GetAliveCount() == KitEntityRegistry::MAX_ENTITIES);
+
+        registry.Destroy(partial[0]);
+        const KitEntityHandle reused = registry.Create();
+        KIT_TEST_CHECK(registry.IsValid(reused));
+        KIT_TEST_CHECK(registry.Create().IsNull());
+    }
+}
+
+int main()
+{
+    KitLog::InitLoggers();
+
+    CheckStaleHandles();
+    CheckConcurrentCreateDestroy();
+    CheckFullRegistry();
+
+    return KitTest::Finish();
+}
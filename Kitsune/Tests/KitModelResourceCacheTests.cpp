@@ -0,0 +1,155 @@
+// Concurrent async loads through KitModelResourceCache. Needs a Vulkan device and a display, exits with
+// SKIP_RETURN_CODE when neither is available so ctest reports the test as skipped.
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "Core/KitJobSystem.h"
+#include "Core/KitLogs.h"
+#include "Core/System/Subsystems/Caches/KitModelResourceCache.h"
+#include "Graphics/KitEngineDevice.h"
+#include "Graphics/KitWindow.h"
+#include "KitTestUtils.h"
+
+namespace
+{
+    // One quad, two triangles once triangulated
+    constexpr const char* QUAD_OBJ =
+        "v -1 -1 0\nv 1 -1 0\nv 1 1 0\nv -1 1 0\n"
+        "vn 0 0 1\n"
+        "f 1//1 2//1 3//1 4//1\n";
+
+    constexpr const char* TRIANGLE_OBJ =
+        "v 0 0 0\nv 1 0 0\nv 0 1 0\n"
+        "vn 0 0 1\n"
+        "f 1//1 2//1 3//1\n";
+
+    std::string WriteSource(const std::filesystem::path& directory, const std::string& name, const char* content)
+    {
+        const std::filesystem::path path = directory / name;
+
+        std::ofstream file(path, std::ios::trunc);
+        file << content;
+
+        return path.string();
+    }
+
+    uint32_t GetIndexCount(const std::shared_ptr<Kitsune::KitModel>& model)
+    {
+        uint32_t index_count = 0;
+        for (const Kitsune::KitMesh& mesh : model->GetMeshes())
+        {
+            index_count += mesh.GetRange().index_count;
+        }
+
+        return index_count;
+    }
+
+    bool IsReady(const std::shared_future<bool>& future)
+    {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+}
+
+int main()
+{
+    using namespace Kitsune;
+
+    if (glfwInit() != GLFW_TRUE || glfwVulkanSupported() != GLFW_TRUE)
+    {
+        std::fprintf(stderr, "No display or Vulkan loader, skipping\n");
+        return KitTest::SKIP_RETURN_CODE;
+    }
+
+    KitLog::InitLoggers();
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "kitsune_model_cache_tests";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // Fresh sources, the mesh binary cache misses and every load goes through Assimp on a worker
+    const std::string quad_path     = WriteSource(directory, "quad.obj", QUAD_OBJ);
+    const std::string triangle_path = WriteSource(directory, "triangle.obj", TRIANGLE_OBJ);
+    const std::string missing_path  = (directory / "missing.obj").string();
+
+    {
+        KitWindow       window(KitWindowInfo(64, 64, "Kitsune Tests"));
+        KitEngineDevice device(&window);
+        KitJobSystem    job_system(4);
+
+        KitModelResourceCache cache(&device, &job_system);
+
+        // Same name and path several times, then the same path under another name, then other paths
+        std::vector<std::shared_future<bool>> quad_loads;
+        for (int i = 0; i < 4; i++)
+        {
+            quad_loads.push_back(cache.LoadFromFileAsync("quad", quad_path));
+        }
+
+        const std::shared_future<bool> quad_alias_load = cache.LoadFromFileAsync("quad_alias", quad_path);
+        const std::shared_future<bool> triangle_load   = cache.LoadFromFileAsync("triangle", triangle_path);
+        const std::shared_future<bool> missing_load    = cache.LoadFromFileAsync("missing", missing_path);
+
+        // Repeated requests share the import already in flight
+        KIT_TEST_CHECK(cache.GetPendingLoadCount() == 4);
+        KIT_TEST_CHECK(cache.GetState("quad") == KitResourceState::PENDING);
+        KIT_TEST_CHECK(cache.Get("quad") == nullptr);
+
+        // Completed one upload per frame, like the frame loop would
+        cache.SetMaxUploadsPerFrame(1);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+        while (cache.GetPendingLoadCount() > 0 && std::chrono::steady_clock::now() < deadline)
+        {
+            const size_t pending_count = cache.GetPendingLoadCount();
+            cache.Update();
+            KIT_TEST_CHECK(pending_count - cache.GetPendingLoadCount() <= 1);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        KIT_TEST_CHECK(cache.GetPendingLoadCount() == 0);
+        cache.WaitForPendingLoads();
+
+        for (const std::shared_future<bool>& quad_load : quad_loads)
+        {
+            KIT_TEST_CHECK(IsReady(quad_load) && quad_load.get());
+        }
+
+        KIT_TEST_CHECK(IsReady(quad_alias_load) && quad_alias_load.get());
+        KIT_TEST_CHECK(IsReady(triangle_load) && triangle_load.get());
+        KIT_TEST_CHECK(IsReady(missing_load) && !missing_load.get());
+
+        const std::shared_ptr<KitModel> quad       = cache.Get("quad");
+        const std::shared_ptr<KitModel> quad_alias = cache.Get("quad_alias");
+        const std::shared_ptr<KitModel> triangle   = cache.Get("triangle");
+
+        KIT_TEST_CHECK(quad != nullptr && GetIndexCount(quad) == 6);
+        KIT_TEST_CHECK(quad_alias != nullptr && GetIndexCount(quad_alias) == 6);
+        KIT_TEST_CHECK(triangle != nullptr && GetIndexCount(triangle) == 3);
+
+        // Another name is another entry, even for the same source
+        KIT_TEST_CHECK(quad != quad_alias);
+
+        KIT_TEST_CHECK(cache.GetState("quad") == KitResourceState::READY);
+        KIT_TEST_CHECK(cache.GetState("missing") == KitResourceState::FAILED);
+        KIT_TEST_CHECK(cache.Get("missing") == nullptr);
+        KIT_TEST_CHECK(cache.GetStats().entry_count == 3);
+
+        // Loading a ready model again neither imports nor replaces it
+        const std::shared_future<bool> reload = cache.LoadFromFileAsync("quad", quad_path);
+        KIT_TEST_CHECK(IsReady(reload) && reload.get());
+        KIT_TEST_CHECK(cache.GetPendingLoadCount() == 0);
+        KIT_TEST_CHECK(cache.Get("quad") == quad);
+
+        device.DeviceWaitIdle();
+    }
+
+    std::filesystem::remove_all(directory);
+
+    return KitTest::Finish();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdio>
+
+// Checks keep going after a failure so a single run reports every broken case, main returns KitTest::Finish()
+#define KIT_TEST_CHECK(condition)                                                              \
+    do                                                                                         \
+    {                                                                                          \
+        if (!(condition))                                                                      \
+        {                                                                                      \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            KitTest::failure_count++;                                                          \
+        }                                                                                      \
+    } while (false)
+
+namespace KitTest
+{
+    // Reported as skipped by ctest, for tests missing a device or a display
+    constexpr int SKIP_RETURN_CODE = 77;
+
+    inline int failure_count = 0;
+
+    inline int Finish()
+    {
+        if (failure_count > 0)
+        {
+            std::fprintf(stderr, "%d checks failed\n", failure_count);
+            return 1;
+        }
+
+        return 0;
+    }
+}
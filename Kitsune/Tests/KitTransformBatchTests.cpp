@@ -0,0 +1,108 @@
+// KitTransformBatch::Compute() against KitTransform::ToMatrix() and GetNormalMatrix(). CPU only, counts around the
+// SIMD width cover the wide loop and the scalar tail.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <vector>
+
+#include "Core/Scene/KitTransformBatch.h"
+#include "KitTestUtils.h"
+
+namespace
+{
+    using namespace Kitsune;
+
+    constexpr float EPSILON = 1e-4f;
+
+    // Angles in radians, negative and several turns past 2 pi
+    constexpr float ANGLES[] = { 0.0f, 0.5f, -1.2f, 3.14159265f, -7.0f, 12.5f, -25.0f, 100.0f };
+
+    bool NearlyEqual(const float a, const float b)
+    {
+        return std::abs(a - b) <= EPSILON * std::max(1.0f, std::abs(b));
+    }
+
+    KitTransform MakeTransform(const size_t seed)
+    {
+        constexpr size_t ANGLE_COUNT = std::size(ANGLES);
+
+        KitTransform transform;
+        transform.translation = glm::vec3(static_cast<float>(seed) * 1.5f - 10.0f, -3.25f, static_cast<float>(seed % 7) * 40.0f);
+        transform.rotation    = glm::vec3(ANGLES[seed % ANGLE_COUNT], ANGLES[(seed + 3) % ANGLE_COUNT], ANGLES[(seed + 5) % ANGLE_COUNT]);
+
+        // Non uniform, every third one mirrored
+        const float sign = seed % 3 == 0 ? -1.0f : 1.0f;
+        transform.scale  = glm::vec3(sign * (0.5f + static_cast<float>(seed % 4)), 2.0f, 0.25f + static_cast<float>(seed % 5));
+
+        return transform;
+    }
+
+    void CheckBatch(const size_t count)
+    {
+        KitTransformBatch batch;
+        batch.Reserve(count);
+
+        std::vector<KitTransform> transforms;
+        for (size_t i = 0; i < count; i++)
+        {
+            transforms.push_back(MakeTransform(i));
+            KIT_TEST_CHECK(batch.Add(transforms.back()) == i);
+        }
+        KIT_TEST_CHECK(batch.GetCount() == count);
+
+        std::vector<glm::mat4> model_matrices(count);
+        std::vector<glm::mat4> normal_matrices(count);
+        batch.Compute(model_matrices.data(), normal_matrices.data());
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const glm::mat4 expected_model  = transforms[i].ToMatrix();
+            const glm::mat3 expected_normal = transforms[i].GetNormalMatrix();
+
+            bool model_matches  = true;
+            bool normal_matches = true;
+            for (int column = 0; column < 4; column++)
+            {
+                for (int row = 0; row < 4; row++)
+                {
+                    model_matches &= NearlyEqual(model_matrices[i][column][row], expected_model[column][row]);
+                }
+            }
+            for (int column = 0; column < 3; column++)
+            {
+                for (int row = 0; row < 3; row++)
+                {
+                    normal_matches &= NearlyEqual(normal_matrices[i][column][row], expected_normal[column][row]);
+                }
+            }
+
+            if (!model_matches || !normal_matches)
+            {
+                std::fprintf(stderr, "Transform %zu of %zu differs\n", i, count);
+            }
+            KIT_TEST_CHECK(model_matches);
+            KIT_TEST_CHECK(normal_matches);
+        }
+    }
+}
+
+int main()
+{
+    std::printf("Transform batch built for %s\n", KitTransformBatch::GetInstructionSet());
+
+    // Below, at and past the 4 and 8 wide loops
+    for (const size_t count : { 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 100 })
+    {
+        CheckBatch(count);
+    }
+
+    KitTransformBatch batch;
+    batch.Add(MakeTransform(0));
+    batch.Clear();
+    KIT_TEST_CHECK(batch.GetCount() == 0);
+    batch.Compute(nullptr, nullptr);
+
+    return KitTest::Finish();
+}